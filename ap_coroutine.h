@@ -0,0 +1,86 @@
+/**
+ * @file ap_coroutine.h
+ */
+
+#ifndef AP_COROUTINE_H
+#define AP_COROUTINE_H
+
+#include <coroutine>
+#include <chrono>
+#include <exception>
+#include <utility>
+
+/*
+	Context of an aperiodic coroutine, used to give the cpu back to the executive:
+	co_await ctx.yield(): continues if the current slack window has time left, otherwise suspends until the next one;
+	co_await ctx.next_frame(): suspends until the slack window of the next frame.
+	The window is only enforced at these points: the coroutine must suspend often enough to end in its window.
+*/
+class ap_context
+{
+	public:
+		struct yield_awaiter
+		{
+			const ap_context & ctx;
+
+			bool await_ready() const noexcept { return ctx.slack_left(); }
+			void await_suspend(std::coroutine_handle<>) const noexcept {}
+			void await_resume() const noexcept {}
+		};
+
+		yield_awaiter yield() const { return yield_awaiter{*this}; }
+		std::suspend_always next_frame() const { return std::suspend_always(); }
+
+		bool slack_left() const { return std::chrono::steady_clock::now() < window_end; }
+
+	private:
+		std::chrono::steady_clock::time_point window_end; //end of the current slack window
+
+		friend class Executive;
+};
+
+/*
+	Aperiodic job written as a C++20 coroutine (see Executive::set_aperiodic_coroutine()):
+	the executive creates it when the aperiodic task is released and resumes it in the slack windows
+	until it completes.
+*/
+class ap_coroutine
+{
+	public:
+		struct promise_type
+		{
+			ap_coroutine get_return_object() { return ap_coroutine(std::coroutine_handle<promise_type>::from_promise(*this)); }
+			std::suspend_always initial_suspend() noexcept { return std::suspend_always(); } //started by the executive
+			std::suspend_always final_suspend() noexcept { return std::suspend_always(); }
+			void return_void() {}
+			void unhandled_exception() { std::terminate(); }
+		};
+
+		ap_coroutine() : handle(nullptr) {}
+		ap_coroutine(ap_coroutine && other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+		~ap_coroutine() { if (handle) handle.destroy(); }
+
+		ap_coroutine & operator =(ap_coroutine && other) noexcept
+		{
+			if (this != &other)
+			{
+				if (handle)
+					handle.destroy();
+				handle = std::exchange(other.handle, nullptr);
+			}
+			return *this;
+		}
+
+		ap_coroutine(const ap_coroutine &) = delete;
+		ap_coroutine & operator =(const ap_coroutine &) = delete;
+
+		bool done() const { return !handle || handle.done(); }
+		void resume() { if (!done()) handle.resume(); }
+
+	private:
+		explicit ap_coroutine(std::coroutine_handle<promise_type> h) : handle(h) {}
+
+		std::coroutine_handle<promise_type> handle;
+};
+
+#endif
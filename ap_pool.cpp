@@ -0,0 +1,319 @@
+/**
+ * @file ap_pool.cpp
+ */
+
+#include <cassert>
+#include <iostream>
+
+#include "ap_pool.h"
+
+//pool and worker of the calling thread (nullptr: not a worker) and its current job
+static thread_local ap_pool * worker_pool = nullptr;
+static thread_local size_t worker_id = 0;
+static thread_local const ap_pool_job * worker_job = nullptr;
+
+// ws_deque ......................................................................................
+
+ws_deque::ws_deque(size_t capacity) : buffer(new std::atomic<ap_pool_job *>[capacity]), mask(capacity - 1), top(0), bottom(0)
+{
+	assert(capacity > 0 && (capacity & (capacity - 1)) == 0); //It fails if the capacity is not a power of 2
+}
+
+bool ws_deque::push(ap_pool_job * job)
+{
+	int64_t b = bottom.load(std::memory_order_relaxed);
+	int64_t t = top.load(std::memory_order_acquire);
+	if (b - t > (int64_t) mask)
+		return false;
+
+	buffer[b & mask].store(job, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	bottom.store(b + 1, std::memory_order_relaxed);
+	return true;
+}
+
+ap_pool_job * ws_deque::pop()
+{
+	int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+	bottom.store(b, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64_t t = top.load(std::memory_order_relaxed);
+
+	if (t > b)
+	{
+		//empty
+		bottom.store(b + 1, std::memory_order_relaxed);
+		return nullptr;
+	}
+
+	ap_pool_job * job = buffer[b & mask].load(std::memory_order_relaxed);
+	if (t == b)
+	{
+		//last job: the owner races with the thieves
+		if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+			job = nullptr;
+		bottom.store(b + 1, std::memory_order_relaxed);
+	}
+	return job;
+}
+
+ap_pool_job * ws_deque::steal()
+{
+	int64_t t = top.load(std::memory_order_acquire);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64_t b = bottom.load(std::memory_order_acquire);
+
+	if (t >= b)
+		return nullptr;
+
+	ap_pool_job * job = buffer[t & mask].load(std::memory_order_relaxed);
+	if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+		return nullptr;
+	return job;
+}
+
+// ap_pool .......................................................................................
+
+ap_pool::ap_pool(const rt::affinity & cpus, size_t capacity, rt::priority prio)
+	: cpu_set(cpus), prio(prio), storage(capacity), shared(capacity), shared_head(0), shared_count(0),
+	  sleeping(0), stopping(false), pending(0), rejected(0)
+{
+	assert(cpus.any()); //It fails if the pool has no cpu
+
+	//each deque can hold every job
+	size_t deque_capacity = 1;
+	while (deque_capacity < capacity)
+		deque_capacity *= 2;
+
+	for (size_t c = 0; c < cpus.size(); ++c)
+		if (cpus.test(c))
+			pool.push_back(std::make_unique<worker>(deque_capacity));
+
+	for (auto & job: storage)
+		free_jobs.push_back(&job);
+}
+
+ap_pool::~ap_pool()
+{
+	stop();
+}
+
+void ap_pool::set_completion(std::function<void(const ap_pool_job &)> completed)
+{
+	this->completed = completed;
+}
+
+const rt::affinity & ap_pool::cpus() const
+{
+	return cpu_set;
+}
+
+size_t ap_pool::workers() const
+{
+	return pool.size();
+}
+
+const ap_pool_job * ap_pool::current_job()
+{
+	return worker_job;
+}
+
+void ap_pool::start()
+{
+	{
+		std::unique_lock<rt::pi_mutex> lock(mtx);
+		stopping = false;
+	}
+
+	size_t id = 0;
+	for (size_t c = 0; c < cpu_set.size(); ++c)
+	{
+		if (!cpu_set.test(c) || pool[id]->thread.joinable())
+		{
+			id += cpu_set.test(c);
+			continue;
+		}
+
+		pool[id]->thread = std::thread(&ap_pool::worker_function, this, id);
+
+		rt::affinity one;
+		one.set(c);
+		rt::set_affinity(pool[id]->thread, one);
+
+		if (prio.is_rt())
+		{
+			try
+			{
+				rt::set_priority(pool[id]->thread, prio);
+			}
+			catch(rt::permission_error & e)
+			{
+				std::cerr << "Error setting the priority of the pool's workers: " << e.what() << std::endl;
+			}
+		}
+		++id;
+	}
+}
+
+void ap_pool::stop()
+{
+	{
+		std::unique_lock<rt::pi_mutex> lock(mtx);
+		stopping = true;
+		cond.notify_all();
+	}
+
+	for (auto & w: pool)
+		if (w->thread.joinable())
+			w->thread.join();
+}
+
+bool ap_pool::submit(std::function<void()> body)
+{
+	return queue(std::move(body), nullptr, ap_request_data(), false, std::chrono::steady_clock::now(), false);
+}
+
+bool ap_pool::submit(const std::function<void()> & body, const ap_request_data & request, bool from_ring,
+	std::chrono::steady_clock::time_point arrival)
+{
+	return queue(std::function<void()>(), &body, request, from_ring, arrival, true);
+}
+
+bool ap_pool::queue(std::function<void()> && owned, const std::function<void()> * body, const ap_request_data & request, bool from_ring,
+	std::chrono::steady_clock::time_point arrival, bool tracked)
+{
+	ap_pool_job * job;
+	{
+		std::unique_lock<rt::pi_mutex> lock(mtx);
+		if (free_jobs.empty())
+		{
+			++rejected;
+			return false;
+		}
+		job = free_jobs.back();
+		free_jobs.pop_back();
+	}
+
+	if (body == nullptr)
+	{
+		job->owned = std::move(owned);
+		body = &job->owned;
+	}
+	job->body = body;
+	job->request = request;
+	job->from_ring = from_ring;
+	job->arrival = arrival;
+	job->tracked = tracked;
+	pending.fetch_add(1, std::memory_order_relaxed);
+
+	//a job of a worker stays on its deque (unless full), where the idle workers steal it
+	bool queued = worker_pool == this && pool[worker_id]->jobs.push(job);
+
+	std::unique_lock<rt::pi_mutex> lock(mtx);
+	if (!queued)
+	{
+		shared[(shared_head + shared_count) % shared.size()] = job;
+		++shared_count;
+	}
+
+	if (sleeping > 0)
+		cond.notify_one();
+
+	return true;
+}
+
+void ap_pool::release(ap_pool_job * job)
+{
+	job->body = nullptr;
+	job->owned = nullptr;
+
+	std::unique_lock<rt::pi_mutex> lock(mtx);
+	free_jobs.push_back(job);
+	pending.fetch_sub(1, std::memory_order_relaxed);
+
+	if (stopping && sleeping > 0)
+		cond.notify_all();
+}
+
+ap_pool_job * ap_pool::take(size_t id)
+{
+	worker & self = *pool[id];
+
+	ap_pool_job * job = self.jobs.pop();
+	if (job != nullptr)
+		return job;
+
+	//steal from the other workers, starting from the next one
+	for (size_t k = 1; k < pool.size(); ++k)
+	{
+		job = pool[(id + k) % pool.size()]->jobs.steal();
+		if (job != nullptr)
+		{
+			++self.stolen;
+			return job;
+		}
+	}
+
+	std::unique_lock<rt::pi_mutex> lock(mtx);
+	if (shared_count == 0)
+		return nullptr;
+
+	job = shared[shared_head];
+	shared_head = (shared_head + 1) % shared.size();
+	--shared_count;
+	return job;
+}
+
+void ap_pool::worker_function(size_t id)
+{
+	worker_pool = this;
+	worker_id = id;
+
+	while (true)
+	{
+		ap_pool_job * job = take(id);
+
+		if (job == nullptr)
+		{
+			std::unique_lock<rt::pi_mutex> lock(mtx);
+			if (stopping && pending.load(std::memory_order_relaxed) == 0)
+				break;
+
+			//the jobs on the deques of running workers are not notified: the idle workers look again every millisecond
+			if (shared_count == 0)
+			{
+				++sleeping;
+				cond.wait_until(lock, std::chrono::steady_clock::now() + std::chrono::milliseconds(1));
+				--sleeping;
+			}
+			continue;
+		}
+
+		worker_job = job;
+		(*job->body)();
+		worker_job = nullptr;
+
+		++pool[id]->executed;
+		if (job->tracked && completed)
+			completed(*job);
+
+		release(job);
+	}
+
+	worker_pool = nullptr;
+}
+
+ap_pool::pool_stats ap_pool::get_stats() const
+{
+	pool_stats s;
+	s.executed = s.stolen = 0;
+	s.rejected = rejected;
+
+	for (auto & w: pool)
+	{
+		s.executed += w->executed;
+		s.stolen += w->stolen;
+		s.per_worker.push_back(w->executed);
+	}
+	return s;
+}
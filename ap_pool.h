@@ -0,0 +1,138 @@
+/**
+ * @file ap_pool.h
+ */
+
+#ifndef AP_POOL_H
+#define AP_POOL_H
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "rt/affinity.h"
+#include "rt/priority.h"
+#include "rt/mutex.h"
+#include "ap_ring.h"
+
+/* Job of the pool: body, with the request it serves and its arrival (aperiodic requests of the executive) */
+struct ap_pool_job
+{
+	const std::function<void()> * body; //owned, or the caller's for a job with a request (not copied)
+	std::function<void()> owned; //body of a job without request
+	ap_request_data request;
+	bool from_ring; //request read from the executive's ring (its completion is published)
+	std::chrono::steady_clock::time_point arrival;
+	bool tracked; //completion reported (see set_completion())
+};
+
+/*
+	Work-stealing deque (Chase-Lev) of a worker, with a fixed capacity (a power of 2): the owner pushes and pops
+	at the bottom, the other workers steal from the top.
+*/
+class ws_deque
+{
+	public:
+		explicit ws_deque(size_t capacity);
+
+		bool push(ap_pool_job * job); //owner: false if full
+		ap_pool_job * pop(); //owner: nullptr if empty
+		ap_pool_job * steal(); //thieves: nullptr if empty or lost to another thief
+
+	private:
+		std::unique_ptr<std::atomic<ap_pool_job *>[]> buffer;
+		size_t mask;
+		alignas(64) std::atomic<int64_t> top;
+		alignas(64) std::atomic<int64_t> bottom;
+};
+
+/*
+	Pool of worker threads executing aperiodic and background jobs on the spare cpus, outside of the periodic schedule
+	(see Executive::set_ap_pool()): one worker per cpu, pinned to it, at a priority below the periodic tasks
+	(default: not real-time). Jobs submitted by other threads enter a shared queue; jobs submitted by a job go to the
+	deque of its worker, and an idle worker steals from the others, so the jobs spread over the workers.
+	The jobs are preallocated (capacity): submit() fails when they are all queued or running.
+	If the cpus of the pool are also used by the periodic schedule, the pool only runs in their idle time.
+*/
+class ap_pool
+{
+	public:
+		/*
+			Statistics (to read after stop()): executed jobs, jobs stolen from another worker, jobs rejected because
+			the pool was full, and jobs executed by each worker.
+		*/
+		struct pool_stats
+		{
+			unsigned long executed;
+			unsigned long stolen;
+			unsigned long rejected;
+			std::vector<unsigned long> per_worker;
+		};
+
+		explicit ap_pool(const rt::affinity & cpus, size_t capacity = 256, rt::priority prio = rt::priority::not_rt);
+		~ap_pool();
+
+		ap_pool(const ap_pool &) = delete;
+		ap_pool & operator=(const ap_pool &) = delete;
+
+		/* Starts the workers; stop() waits for the queued jobs, then for the workers */
+		void start();
+		void stop();
+
+		/*
+			Queues a job (from any thread, or from a job for its own worker); false if the pool is full.
+			With a request the body is not copied (no allocation on the executive's path): it must outlive the job.
+		*/
+		bool submit(std::function<void()> body);
+		bool submit(const std::function<void()> & body, const ap_request_data & request, bool from_ring,
+			std::chrono::steady_clock::time_point arrival);
+
+		/* Called by the worker after each job submitted with a request (to set before start()) */
+		void set_completion(std::function<void(const ap_pool_job &)> completed);
+
+		const rt::affinity & cpus() const;
+		size_t workers() const;
+		pool_stats get_stats() const;
+
+		/* Job running on the calling thread (nullptr out of the pool's workers) */
+		static const ap_pool_job * current_job();
+
+	private:
+		struct alignas(64) worker
+		{
+			worker(size_t capacity) : jobs(capacity), executed(0), stolen(0) {}
+
+			std::thread thread;
+			ws_deque jobs;
+			unsigned long executed;
+			unsigned long stolen;
+		};
+
+		rt::affinity cpu_set;
+		rt::priority prio;
+		std::vector<std::unique_ptr<worker>> pool;
+
+		std::vector<ap_pool_job> storage;
+		std::vector<ap_pool_job *> free_jobs; //with mtx
+		std::vector<ap_pool_job *> shared; //jobs of the other threads, circular (with mtx)
+		size_t shared_head;
+		size_t shared_count;
+
+		rt::pi_mutex mtx;
+		rt::condition_variable cond; //jobs queued or stop
+		unsigned int sleeping; //with mtx
+		bool stopping; //with mtx
+		std::atomic<unsigned long> pending; //queued and running jobs
+		unsigned long rejected; //with mtx
+
+		std::function<void(const ap_pool_job &)> completed;
+
+		bool queue(std::function<void()> && owned, const std::function<void()> * body, const ap_request_data & request, bool from_ring,
+			std::chrono::steady_clock::time_point arrival, bool tracked);
+		ap_pool_job * take(size_t id);
+		void release(ap_pool_job * job);
+		void worker_function(size_t id);
+};
+
+#endif
@@ -0,0 +1,136 @@
+/**
+ * @file ap_ring.cpp
+ */
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/eventfd.h>
+#include <sys/syscall.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <ctime>
+#include <cerrno>
+#include <new>
+
+#include "ap_ring.h"
+
+ap_ring * ap_ring_create(const char * name, uint32_t capacity, int doorbell, mode_t mode)
+{
+	uint32_t slots = 1;
+	while (slots < capacity)
+		slots <<= 1;
+
+	int fd = shm_open(name, O_CREAT | O_RDWR | O_TRUNC, mode);
+	if (fd < 0)
+		return nullptr;
+
+	//a segment left by a previous run keeps its mode: the producers allowed are the given ones
+	if (fchmod(fd, mode) != 0)
+	{
+		close(fd);
+		return nullptr;
+	}
+
+	size_t size = ap_ring::size(slots);
+	if (ftruncate(fd, size) != 0)
+	{
+		close(fd);
+		return nullptr;
+	}
+
+	void * addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (addr == MAP_FAILED)
+		return nullptr;
+
+	mlock(addr, size); //no page faults on the executive's side (best effort)
+
+	ap_ring * ring = new (addr) ap_ring();
+	for (uint32_t i = 0; i < slots; ++i)
+	{
+		ap_ring_slot * slot = new (&ring->slots()[i]) ap_ring_slot();
+		slot->seq.store(i, std::memory_order_relaxed);
+	}
+
+	ring->capacity = slots;
+	for (uint32_t i = 0; i < slots; ++i)
+		new (&ring->completions()[i]) std::atomic<uint64_t>(0);
+
+	ring->doorbell_pid = doorbell >= 0 ? getpid() : 0;
+	ring->doorbell_fd = doorbell;
+
+	//the producers check the magic number after mapping the segment
+	std::atomic_thread_fence(std::memory_order_release);
+	ring->magic = ap_ring::MAGIC;
+
+	return ring;
+}
+
+ap_ring * ap_ring_open(const char * name)
+{
+	int fd = shm_open(name, O_RDWR, 0);
+	if (fd < 0)
+		return nullptr;
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || (size_t) st.st_size < sizeof(ap_ring))
+	{
+		close(fd);
+		return nullptr;
+	}
+
+	void * addr = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (addr == MAP_FAILED)
+		return nullptr;
+
+	ap_ring * ring = static_cast<ap_ring *>(addr);
+	if (ring->magic != ap_ring::MAGIC || ap_ring::size(ring->capacity) > (size_t) st.st_size)
+	{
+		munmap(addr, st.st_size);
+		return nullptr;
+	}
+
+	return ring;
+}
+
+void ap_ring_close(ap_ring * ring)
+{
+	munmap(ring, ap_ring::size(ring->capacity));
+}
+
+int ap_ring_doorbell(ap_ring * ring)
+{
+	if (ring->doorbell_pid == 0)
+	{
+		errno = ENOENT;
+		return -1;
+	}
+
+	//an eventfd cannot be reopened through /proc/<pid>/fd: it is duplicated from the owner's table
+	int pidfd = syscall(SYS_pidfd_open, ring->doorbell_pid, 0);
+	if (pidfd < 0)
+		return -1;
+
+	int fd = syscall(SYS_pidfd_getfd, pidfd, ring->doorbell_fd, 0);
+	int error = errno;
+	close(pidfd);
+
+	errno = error;
+	return fd;
+}
+
+bool ap_ring_send(ap_ring * ring, int doorbell, ap_request_data & request)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	request.sent_ns = now.tv_sec * 1000000000LL + now.tv_nsec;
+
+	if (!ring->push(request))
+		return false;
+
+	if (doorbell >= 0)
+		eventfd_write(doorbell, 1);
+
+	return true;
+}
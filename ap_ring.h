@@ -0,0 +1,187 @@
+/**
+ * @file ap_ring.h
+ */
+
+#ifndef AP_RING_H
+#define AP_RING_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <sys/types.h>
+
+/*
+	Aperiodic release request, written by a producer in the request ring.
+*/
+struct ap_request_data
+{
+	static const size_t PAYLOAD_SIZE = 32;
+
+	uint64_t id; //chosen by the producer (not 0, unique among the requests in flight), published when the job ends
+	int64_t sent_ns; //CLOCK_MONOTONIC time of the request (set by ap_ring_send())
+	uint16_t type; //kind of aperiodic request, interpreted by the aperiodic task
+	uint16_t deadline; //relative deadline, in frames (0: until the next request)
+	uint32_t size; //payload bytes
+	uint8_t payload[PAYLOAD_SIZE];
+};
+
+struct alignas(64) ap_ring_slot
+{
+	std::atomic<uint64_t> seq; //position of the ring the slot is ready for
+	ap_request_data request;
+};
+
+/*
+	Layout of the POSIX shared-memory segment where external processes post aperiodic requests to the executive.
+	Any number of producers reserve a position with an atomic increment of head and publish the slot with its
+	sequence number, so they never take a lock; the executive is the only consumer and drains the ring at each
+	frame boundary without blocking; while the aperiodic job runs the requests wait in the ring, in order.
+	The request slots follow the structure, then the completion slots: the job of request "id" stores it in the
+	completion slot id % capacity, so the producers see every completion also when the jobs end out of order
+	(aperiodic pool), as long as fewer than capacity requests are in flight.
+	Optionally the executive owns an eventfd (the doorbell) that producers write after each request.
+*/
+struct ap_ring
+{
+	static const uint32_t MAGIC = 0x41505251;
+
+	uint32_t magic;
+	uint32_t capacity; //slots, power of two
+	int32_t doorbell_pid; //process owning the doorbell (0: no doorbell)
+	int32_t doorbell_fd; //doorbell's descriptor in doorbell_pid
+
+	std::atomic<uint64_t> completed; //id of the last completed request (see is_complete() for each request)
+	std::atomic<uint64_t> dropped; //requests rejected because the ring was full
+
+	alignas(64) std::atomic<uint64_t> head; //next position to write (producers)
+	alignas(64) std::atomic<uint64_t> tail; //next position to read (executive)
+
+	static size_t size(uint32_t capacity);
+
+	ap_ring_slot * slots();
+	std::atomic<uint64_t> * completions();
+
+	// producer side: returns false if the ring is full
+	bool push(const ap_request_data & request);
+
+	// consumer side: returns false if the ring is empty
+	bool pop(ap_request_data & request);
+
+	// consumer side: a request is ready to be popped
+	bool waiting();
+
+	// consumer side: publishes the completion of the request "id" (from any thread)
+	void complete(uint64_t id);
+
+	// producer side: the job of the request "id" has completed
+	bool is_complete(uint64_t id);
+};
+
+/*
+	Creates (or truncates) the segment "name" with "capacity" slots (rounded up to a power of two)
+	and maps it, locked in memory. doorbell: eventfd of the calling process written by the producers (-1: none);
+	mode: permissions of the segment (default: the producers must run as the same user).
+	Returns nullptr on failure.
+*/
+ap_ring * ap_ring_create(const char * name, uint32_t capacity, int doorbell, mode_t mode = 0600);
+
+/*
+	Maps an existing segment for writing requests. Returns nullptr on failure.
+*/
+ap_ring * ap_ring_open(const char * name);
+
+void ap_ring_close(ap_ring * ring);
+
+/*
+	Producer: duplicates the ring's doorbell in the calling process (pidfd_getfd(), Linux 5.6).
+	Returns -1 with errno ENOENT if the ring has no doorbell, or with the error of the duplication: EPERM if the
+	process may not take it (pidfd_getfd() needs ptrace access to the executive's process, which Yama restricts
+	to its ancestors with ptrace_scope 1). Without doorbell the requests are served at the next frame boundary.
+*/
+int ap_ring_doorbell(ap_ring * ring);
+
+/*
+	Producer: timestamps and posts the request, then rings the doorbell (if doorbell >= 0).
+	Returns false if the ring is full.
+*/
+bool ap_ring_send(ap_ring * ring, int doorbell, ap_request_data & request);
+
+// ...............................................................................................
+
+inline size_t ap_ring::size(uint32_t capacity)
+{
+	return sizeof(ap_ring) + capacity * (sizeof(ap_ring_slot) + sizeof(std::atomic<uint64_t>));
+}
+
+inline ap_ring_slot * ap_ring::slots()
+{
+	return reinterpret_cast<ap_ring_slot *>(this + 1);
+}
+
+inline std::atomic<uint64_t> * ap_ring::completions()
+{
+	return reinterpret_cast<std::atomic<uint64_t> *>(slots() + capacity);
+}
+
+inline bool ap_ring::push(const ap_request_data & request)
+{
+	uint64_t pos = head.load(std::memory_order_relaxed);
+
+	while (true)
+	{
+		ap_ring_slot & slot = slots()[pos & (capacity - 1)];
+		uint64_t seq = slot.seq.load(std::memory_order_acquire);
+
+		if (seq == pos)
+		{
+			if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+			{
+				slot.request = request;
+				slot.seq.store(pos + 1, std::memory_order_release);
+				return true;
+			}
+		}
+		else if (seq < pos)
+		{
+			//the slot still holds the request of the previous lap
+			dropped.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+		else
+			pos = head.load(std::memory_order_relaxed);
+	}
+}
+
+inline bool ap_ring::pop(ap_request_data & request)
+{
+	uint64_t pos = tail.load(std::memory_order_relaxed);
+	ap_ring_slot & slot = slots()[pos & (capacity - 1)];
+
+	if (slot.seq.load(std::memory_order_acquire) != pos + 1)
+		return false;
+
+	request = slot.request;
+	slot.seq.store(pos + capacity, std::memory_order_release);
+	tail.store(pos + 1, std::memory_order_relaxed);
+
+	return true;
+}
+
+inline bool ap_ring::waiting()
+{
+	uint64_t pos = tail.load(std::memory_order_relaxed);
+	return slots()[pos & (capacity - 1)].seq.load(std::memory_order_acquire) == pos + 1;
+}
+
+inline void ap_ring::complete(uint64_t id)
+{
+	completions()[id & (capacity - 1)].store(id, std::memory_order_release);
+	completed.store(id, std::memory_order_release);
+}
+
+inline bool ap_ring::is_complete(uint64_t id)
+{
+	return completions()[id & (capacity - 1)].load(std::memory_order_acquire) == id;
+}
+
+#endif
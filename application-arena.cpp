@@ -0,0 +1,78 @@
+/**
+ * @file application-arena.cpp
+ *
+ * Job arenas: tau_1 builds a message of random size in a vector on the arena of its task, tau_2 allocates
+ * temporary records, the aperiodic task a buffer. Nothing is freed: each arena is emptied at the start of the next
+ * job. The high-water mark of each arena is printed when run() returns, to size the arenas.
+ */
+
+#include "executive.h"
+#include "busy_wait.h"
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <random>
+
+Executive exec(2, 4);
+
+std::mt19937 rng(1);
+
+struct sample
+{
+	unsigned int id;
+	double value;
+};
+
+void task0()
+{
+	//the vector grows on the arena: its old buffers stay there until the next job
+	std::vector<char, arena_allocator<char>> message;
+	unsigned int size = std::uniform_int_distribution<unsigned int>(64, 1024)(rng);
+	for (unsigned int i = 0; i < size; i++)
+		message.push_back('a' + i % 26);
+
+	busy_wait(10*0.8);
+}
+
+void task1()
+{
+	job_arena * arena = job_arena::current();
+	for (unsigned int i = 0; i < 32; i++)
+		if (arena->make<sample>(sample{i, i * 0.5}) == nullptr)
+			break;
+
+	busy_wait(10*1.5);
+
+	exec.ap_task_request();
+}
+
+void ap_task()
+{
+	char * buffer = static_cast<char *>(job_arena::current()->allocate(4096, 64));
+	if (buffer != nullptr)
+		buffer[0] = 0;
+
+	busy_wait(10*1);
+}
+
+int main()
+{
+	busy_wait_init();
+
+	exec.set_periodic_task(0, task0, 1); // tau_1
+	exec.set_periodic_task(1, task1, 2); // tau_2
+
+	exec.set_aperiodic_task(ap_task, 2);
+
+	exec.add_frame({0,1});
+	exec.add_frame({0});
+
+	exec.set_job_arena(0, 4096);
+	exec.set_job_arena(1, 1024);
+	exec.set_job_arena(2, 8192); // aperiodic task
+
+	exec.set_verbose(false);
+	exec.run(10);
+
+	return 0;
+}
@@ -0,0 +1,108 @@
+/**
+ * @file application-cancel.cpp
+ *
+ * Cancellation of late aperiodic jobs: the schedule of application-err_ap, where the aperiodic job (250ms in slices
+ * of 10ms) is longer than the time between two requests. Without cancellation the stale job keeps every slack window
+ * and the new requests wait behind it; with "cancel" the job checks its token between the slices, returns when the
+ * next request arrives, and that request is served.
+ *
+ * usage: application-cancel [cancel]
+ */
+
+#include "executive.h"
+#include "busy_wait.h"
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <atomic>
+
+Executive exec(5, 4);
+int count = 0;
+
+std::atomic<unsigned int> completed(0);
+std::atomic<unsigned int> cancelled(0);
+
+void task0()
+{
+	busy_wait(10*0.7);
+}
+
+void task1()
+{
+	busy_wait(10*1.7);
+}
+
+void task2()
+{
+	busy_wait(10*0.7);
+}
+
+void task3()
+{
+	busy_wait(10*2.7);
+
+	if (count % 3 == 0)
+		exec.ap_task_request();
+	count++;
+}
+
+void task4()
+{
+	busy_wait(10*0.7);
+}
+
+void ap_job(const cancel_token & token)
+{
+	for (unsigned int slice = 0; slice < 25; slice++)
+	{
+		//preemption point: the result of a late job is useless
+		if (token.cancelled())
+		{
+			cancelled.fetch_add(1);
+			return;
+		}
+		busy_wait(10);
+	}
+	completed.fetch_add(1);
+}
+
+void ap_task()
+{
+	static cancel_token never;
+	ap_job(never);
+}
+
+int main(int argc, char * argv[])
+{
+	busy_wait_init();
+
+	bool cancel = argc > 1 && std::string(argv[1]) == "cancel";
+
+	exec.set_periodic_task(0, task0, 1); // tau_1
+	exec.set_periodic_task(1, task1, 2); // tau_2
+	exec.set_periodic_task(2, task2, 1); // tau_3,1
+	exec.set_periodic_task(3, task3, 3); // tau_3,2
+	exec.set_periodic_task(4, task4, 1); // tau_3,3
+
+	if (cancel)
+		exec.set_aperiodic_task(ap_job, 2);
+	else
+		exec.set_aperiodic_task(ap_task, 2);
+
+	exec.add_frame({0,1,2});
+	exec.add_frame({0,3});
+	exec.add_frame({0,1});
+	exec.add_frame({0,1});
+	exec.add_frame({0,1,4});
+
+	exec.set_verbose(false);
+	exec.run(12);
+
+	Executive::exec_stats stats = exec.get_stats();
+	std::ostringstream report;
+	report << (cancel ? "cancel" : "run to completion") << ": periodic misses " << stats.misses << ", aperiodic misses "
+		<< stats.ap_misses << ", aperiodic jobs completed " << completed.load() << ", cancelled " << cancelled.load() << std::endl;
+	std::cout << report.str();
+
+	return 0;
+}
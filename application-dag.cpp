@@ -0,0 +1,80 @@
+/**
+ * @file application-dag.cpp
+ *
+ * Fork-join frame: tau_1 produces the input of tau_2, tau_3 and tau_4, which are independent, and tau_5 joins
+ * their results. On one cpu the frame's jobs run one after the other; with more cpus (up to 3 are used) the three
+ * middle jobs run in parallel and the larger slack time is left to the aperiodic task.
+ */
+
+#include "executive.h"
+#include "busy_wait.h"
+#include <iostream>
+#include <sstream>
+#include <atomic>
+#include <thread>
+
+Executive exec(5, 12);
+
+std::atomic<unsigned int> stage(0);
+unsigned int count = 0;
+
+void source()
+{
+	busy_wait(10*0.8);
+	stage.store(1);
+}
+
+void worker()
+{
+	//the precedence edges guarantee the source's output
+	if (stage.load() != 1)
+		std::cout << "worker started before the source" << std::endl;
+
+	busy_wait(10*2.5);
+}
+
+void join()
+{
+	busy_wait(10*0.8);
+	stage.store(0);
+
+	if (++count % 2 == 0)
+		exec.ap_task_request();
+}
+
+void ap_task()
+{
+	busy_wait(10*4);
+}
+
+int main()
+{
+	busy_wait_init();
+
+	unsigned int cpus = std::min(3u, std::max(1u, std::thread::hardware_concurrency()));
+	rt::affinity aff;
+	for (unsigned int c = 0; c < cpus; c++)
+		aff.set(c);
+	exec.set_affinity(aff);
+
+	exec.set_periodic_task(0, source, 1); // tau_1
+	exec.set_periodic_task(1, worker, 3); // tau_2
+	exec.set_periodic_task(2, worker, 3); // tau_3
+	exec.set_periodic_task(3, worker, 3); // tau_4
+	exec.set_periodic_task(4, join, 1); // tau_5
+
+	exec.set_aperiodic_task(ap_task, 5);
+
+	exec.add_frame({0,1,2,3,4}, {{0,1}, {0,2}, {0,3}, {1,4}, {2,4}, {3,4}});
+
+	std::cout << "cpus " << cpus << ", slack time " << exec.slack_time(0) << " units of 12" << std::endl;
+
+	exec.set_verbose(false);
+	exec.run(20);
+
+	Executive::exec_stats stats = exec.get_stats();
+	std::cout << "frames " << stats.frames << ", periodic misses " << stats.misses << ", aperiodic jobs " << stats.ap_jobs
+		<< " (misses " << stats.ap_misses << ")" << std::endl;
+
+	return 0;
+}
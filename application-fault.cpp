@@ -0,0 +1,94 @@
+/**
+ * @file application-fault.cpp
+ *
+ * The schedule of application-ok with injected faults, instead of the longer busy waits of application-err_p
+ * and application-err_ap: it prints the recovery latency of the executive.
+ *
+ * usage: application-fault [fault script | seed]
+ */
+
+#include "executive.h"
+#include "busy_wait.h"
+#include <iostream>
+#include <sstream>
+#include <cstdlib>
+#include <cctype>
+
+Executive exec(3, 4);
+
+void task0()
+{
+	busy_wait(10*0.7);
+}
+
+void task1()
+{
+	busy_wait(10*1.7);
+}
+
+void task2()
+{
+	busy_wait(10*0.7);
+}
+
+void task3()
+{
+	busy_wait(10*2.7);
+}
+
+void task4()
+{
+	busy_wait(10*0.7);
+}
+
+void ap_task()
+{
+	busy_wait(10*1.5);
+}
+
+int main(int argc, char * argv[])
+{
+	busy_wait_init();
+
+	exec.set_periodic_task(0, task0, 1); // tau_1
+	exec.set_periodic_task(1, task1, 2); // tau_2
+	exec.set_sliced_task(2, {task2, task3, task4}, {1, 3, 1}); // tau_3 (tau_3,1 tau_3,2 tau_3,3)
+
+	exec.set_aperiodic_task(ap_task, 2);
+
+	exec.add_frame({0,1,2});
+	exec.add_frame({0,2});
+	exec.add_frame({0,1});
+	exec.add_frame({0,1});
+	exec.add_frame({0,1,2});
+
+	fault_injector faults;
+	if (argc > 1 && std::isdigit(argv[1][0]))
+	{
+		faults.set_random(std::strtoull(argv[1], nullptr, 10), 0.02, 3, 0.02, 3);
+	}
+	else if (argc > 1)
+	{
+		if (!faults.load(argv[1]))
+			return 1;
+	}
+	else
+	{
+		faults.add_overrun(10, 1, 2); //tau_2 overruns by 2 units
+		faults.add_stall(31, 0, 2); //tau_1 blocks for 2 units before its body
+		faults.add_burst(52, 3); //3 aperiodic requests in the same frame
+		faults.add_overrun(75, 2, 4); //tau_3,1 overruns by a whole frame
+	}
+
+	exec.set_fault_injector(faults);
+	exec.set_accounting(true);
+	exec.set_perf_counters(true);
+	exec.set_verbose(false);
+
+	exec.run(20);
+
+	Executive::exec_stats stats = exec.get_stats();
+	std::cout << "frames " << stats.frames << ", periodic misses " << stats.misses << ", aperiodic misses " << stats.ap_misses << std::endl;
+
+	return 0;
+}
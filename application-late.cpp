@@ -0,0 +1,101 @@
+/**
+ * @file application-late.cpp
+ *
+ * Late executive: a thread at the executive's priority on its cpu (as an SMI or a kernel delay would) holds the cpu
+ * for 100ms every second, so the executive wakes up more than two frames late. With "catch-up" the late frames run
+ * back to back and their jobs miss their deadlines; "skip" drops the late frames and keeps the phase of the
+ * hyperperiod; "shift" moves the timeline to the late wake-up.
+ *
+ * usage: application-late [catch-up | skip | shift]
+ */
+
+#include "executive.h"
+#include "busy_wait.h"
+#include "rt/priority.h"
+#include "rt/affinity.h"
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <atomic>
+#include <thread>
+
+Executive exec(2, 4);
+
+std::atomic<bool> done(false);
+
+void task0()
+{
+	busy_wait(10*0.8);
+}
+
+void task1()
+{
+	busy_wait(10*1.5);
+}
+
+void ap_task()
+{
+	busy_wait(10*1);
+}
+
+void hiccup()
+{
+	while (!done.load())
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(900));
+		busy_wait(100);
+	}
+}
+
+int main(int argc, char * argv[])
+{
+	busy_wait_init();
+
+	std::string mode = argc > 1 ? argv[1] : "catch-up";
+	if (mode == "skip")
+		exec.set_overrun_policy(Executive::SKIP);
+	else if (mode == "shift")
+		exec.set_overrun_policy(Executive::SHIFT);
+	else if (mode == "catch-up")
+		exec.set_overrun_policy(Executive::CATCH_UP);
+	else
+	{
+		std::cerr << "usage: " << argv[0] << " [catch-up | skip | shift]" << std::endl;
+		return 1;
+	}
+
+	exec.set_periodic_task(0, task0, 1); // tau_1
+	exec.set_periodic_task(1, task1, 2); // tau_2
+
+	exec.set_aperiodic_task(ap_task, 2);
+
+	exec.add_frame({0,1});
+	exec.add_frame({0});
+
+	std::thread delay(hiccup);
+	rt::affinity aff("1");
+	rt::set_affinity(delay, aff);
+	try
+	{
+		rt::set_priority(delay, rt::priority::rt_max);
+	}
+	catch(rt::permission_error & e)
+	{
+		std::cerr << "Error setting the priority of the delay thread: " << e.what() << std::endl;
+	}
+
+	exec.set_verbose(false);
+	exec.run(50);
+
+	done.store(true);
+	delay.join();
+
+	Executive::exec_stats stats = exec.get_stats();
+	std::ostringstream report;
+	report << mode << ": frames " << stats.frames << ", periodic misses " << stats.misses << ", late starts " << stats.late_starts
+		<< " (max " << std::chrono::duration<double, std::milli>(stats.max_late_start).count() << " ms), skipped frames "
+		<< stats.skipped_frames << ", timeline shift " << std::chrono::duration<double, std::milli>(stats.total_shift).count() << " ms" << std::endl;
+	std::cout << report.str();
+
+	return 0;
+}
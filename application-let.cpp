@@ -0,0 +1,71 @@
+/**
+ * @file application-let.cpp
+ *
+ * Logical Execution Time communication: tau_1 produces a sample in each of its jobs and tau_2 reads it without
+ * locks. tau_2 always reads the sample published at the end of the previous frame, whatever the order and the
+ * execution time of the jobs in the frame.
+ */
+
+#include "executive.h"
+#include "busy_wait.h"
+#include <iostream>
+#include <sstream>
+
+struct sample
+{
+	unsigned long seq;
+	double value;
+};
+
+Executive exec(2, 4);
+
+let_buffer<sample> samples;
+let_input<sample> samples_in(samples);
+
+unsigned long produced = 0;
+
+void task0()
+{
+	busy_wait(10*0.5);
+
+	sample & out = samples.write();
+	out.seq = ++produced;
+	out.value = produced * 0.5;
+}
+
+void task1()
+{
+	const sample & in = samples_in.read();
+
+	busy_wait(10*1.5); //the sample cannot change while the job runs
+
+	std::ostringstream debug;
+	debug << "Task 1 reads sample " << in.seq << " (value " << in.value << "), produced " << produced << std::endl;
+	std::cout << debug.str();
+}
+
+void ap_task()
+{
+}
+
+int main()
+{
+	busy_wait_init();
+
+	exec.set_periodic_task(0, task0, 1); // tau_1
+	exec.set_periodic_task(1, task1, 2); // tau_2
+
+	exec.set_let_output(0, samples);
+	exec.set_let_input(1, samples_in);
+
+	exec.set_aperiodic_task(ap_task, 1);
+
+	exec.add_frame({0,1});
+	exec.add_frame({1,0});
+	exec.add_frame({1});
+
+	exec.set_verbose(false);
+	exec.run(4);
+
+	return 0;
+}
@@ -8,7 +8,7 @@
 #include "busy_wait.h"
 #include <iostream>
 #include <sstream>
-Executive exec(5, 4);
+Executive exec(3, 4);
 int count = 0;
 
 
@@ -99,20 +99,20 @@ int main()
 
 	exec.set_periodic_task(0, task0, 1); // tau_1
 	exec.set_periodic_task(1, task1, 2); // tau_2
-	exec.set_periodic_task(2, task2, 1); // tau_3,1
-	exec.set_periodic_task(3, task3, 3); // tau_3,2
-	exec.set_periodic_task(4, task4, 1); // tau_3,3
+	exec.set_sliced_task(2, {task2, task3, task4}, {1, 3, 1}); // tau_3 (tau_3,1 tau_3,2 tau_3,3)
 	/* ... */ 
 	
 	exec.set_aperiodic_task(ap_task, 2);
 	
 	exec.add_frame({0,1,2});
-	exec.add_frame({0,3});
+	exec.add_frame({0,2});
 	exec.add_frame({0,1});
 	exec.add_frame({0,1});
-	exec.add_frame({0,1,4});
+	exec.add_frame({0,1,2});
 	/* ... */
 	
+	exec.set_shm_stats("/application-ok"); // live counters: ./shm-monitor /application-ok
+	
 	exec.run();
 	
 	return 0;
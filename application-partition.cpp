@@ -0,0 +1,86 @@
+/**
+ * @file application-partition.cpp
+ *
+ * Two applications in time partitions on cpu 0, major frame of 100 ms:
+ * partition A (frames of 20 ms) in the windows [0, 40) and [80, 100) ms, partition B (frames of 40 ms) in [40, 80) ms.
+ * Every fourth job of B's tau_1 overruns its window: it is demoted at the end of the window, so A's jobs are
+ * not delayed, and it is a deadline miss of B only.
+ */
+
+#include "partition.h"
+#include "busy_wait.h"
+#include <iostream>
+#include <sstream>
+
+Executive exec_a(2, 2);
+Executive exec_b(2, 4);
+
+unsigned int count_b = 0;
+
+void a_task0()
+{
+	busy_wait(10*0.7);
+}
+
+void a_task1()
+{
+	busy_wait(10*0.7);
+}
+
+void b_task0()
+{
+	busy_wait(10*0.7);
+}
+
+void b_task1()
+{
+	//overrun: beyond the 40 ms window
+	busy_wait(++count_b % 4 == 0 ? 10*4.5 : 10*1.7);
+}
+
+void ap_task()
+{
+}
+
+int main()
+{
+	busy_wait_init();
+
+	exec_a.set_periodic_task(0, a_task0, 1);
+	exec_a.set_periodic_task(1, a_task1, 1);
+	exec_a.set_aperiodic_task(ap_task, 1);
+	exec_a.add_frame({0,1});
+	exec_a.add_frame({0});
+
+	exec_b.set_periodic_task(0, b_task0, 1);
+	exec_b.set_periodic_task(1, b_task1, 2);
+	exec_b.set_aperiodic_task(ap_task, 1);
+	exec_b.add_frame({0,1});
+
+	exec_a.set_verbose(false);
+	exec_b.set_verbose(false);
+
+	partition_scheduler sched(std::chrono::milliseconds(100));
+	size_t a = sched.add_partition(exec_a, 15);
+	size_t b = sched.add_partition(exec_b, 10);
+
+	sched.add_window(a, std::chrono::milliseconds(0), std::chrono::milliseconds(40));
+	sched.add_window(b, std::chrono::milliseconds(40), std::chrono::milliseconds(40));
+	sched.add_window(a, std::chrono::milliseconds(80), std::chrono::milliseconds(20));
+
+	sched.run();
+
+	for (size_t p: {a, b})
+	{
+		Executive::exec_stats stats = (p == a ? exec_a : exec_b).get_stats();
+		partition_scheduler::partition_stats ps = sched.get_stats(p);
+
+		std::ostringstream report;
+		report << "partition " << (p == a ? "A" : "B") << ": frames " << stats.frames << ", misses " << stats.misses
+			<< ", windows " << ps.windows << ", jobs cut at the window end " << ps.cut_jobs
+			<< ", window start latency max " << std::chrono::duration<double, std::micro>(ps.max_latency).count() << " us" << std::endl;
+		std::cout << report.str();
+	}
+
+	return 0;
+}
@@ -0,0 +1,95 @@
+/**
+ * @file application-pool.cpp
+ *
+ * Aperiodic pool: the periodic schedule runs on cpu 0, the aperiodic requests and a background computation run on
+ * the workers of a work-stealing pool on the other cpus (on a single cpu the pool shares cpu 0 and only runs in the
+ * idle time of the schedule). tau_2 requests an aperiodic job longer than the slack time of its frame, which the
+ * pool serves without waiting for the next frames; the background job splits itself into chunks that the idle
+ * workers steal.
+ */
+
+#include "executive.h"
+#include "busy_wait.h"
+#include <iostream>
+#include <sstream>
+#include <atomic>
+#include <thread>
+
+Executive exec(2, 4);
+
+std::atomic<unsigned int> chunks(0);
+
+void task0()
+{
+	busy_wait(10*0.8);
+}
+
+void task1()
+{
+	busy_wait(10*1.5);
+
+	exec.ap_task_request();
+}
+
+void ap_task()
+{
+	busy_wait(10*2);
+}
+
+//background job: halves its range until one chunk is left, the other half is queued on the worker's deque
+void background(ap_pool & pool, unsigned int n)
+{
+	while (n > 1)
+	{
+		unsigned int half = n / 2;
+		if (!pool.submit([&pool, half]() { background(pool, half); }))
+			break;
+		n -= half;
+	}
+
+	busy_wait(5 * n);
+	chunks.fetch_add(n);
+}
+
+int main()
+{
+	busy_wait_init();
+
+	unsigned int cpus = std::max(1u, std::thread::hardware_concurrency());
+	rt::affinity pool_cpus;
+	for (unsigned int c = 1; c < std::min(cpus, (unsigned int) pool_cpus.size()); c++)
+		pool_cpus.set(c);
+	if (pool_cpus.none())
+		pool_cpus.set(0);
+
+	ap_pool pool(pool_cpus);
+
+	exec.set_periodic_task(0, task0, 1); // tau_1
+	exec.set_periodic_task(1, task1, 2); // tau_2
+
+	exec.set_aperiodic_task(ap_task, 2);
+
+	exec.add_frame({0,1});
+	exec.add_frame({0});
+
+	exec.set_ap_pool(pool);
+
+	//the background job waits in the pool's queue until run() starts the workers
+	pool.submit([&pool]() { background(pool, 32); });
+
+	exec.set_verbose(false);
+	exec.run(10);
+
+	Executive::exec_stats stats = exec.get_stats();
+	std::chrono::duration<double, std::milli> ap_mean(stats.total_ap_response);
+	if (stats.ap_jobs > 0)
+		ap_mean /= stats.ap_jobs;
+
+	std::ostringstream report;
+	report << "frames " << stats.frames << ", periodic misses " << stats.misses << ", aperiodic jobs " << stats.ap_jobs
+		<< " (misses " << stats.ap_misses << "), aperiodic response mean " << ap_mean.count() << " ms, background chunks "
+		<< chunks.load() << " of 32" << std::endl;
+	std::cout << report.str();
+
+	return 0;
+}
@@ -0,0 +1,108 @@
+/**
+ * @file application-trace.cpp
+ *
+ * Record and replay: the jobs of the schedule of application-ok have random durations and tau_3 requests the
+ * aperiodic task at random, so two live runs differ. "record" saves the arrivals and the execution times of a run,
+ * "replay" re-injects the same arrivals with synthetic bodies of the same durations ("replay-bodies" keeps the
+ * real bodies), so that the timing of two builds can be compared on the same workload.
+ *
+ * usage: application-trace [record <trace> | replay <trace> | replay-bodies <trace>]
+ */
+
+#include "executive.h"
+#include "busy_wait.h"
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <random>
+
+Executive exec(3, 4);
+
+std::mt19937 rng(std::random_device{}());
+
+//random execution time up to the wcet (the bodies run on the same core: the generator needs no lock)
+void job(unsigned int wcet)
+{
+	std::uniform_int_distribution<unsigned int> ms(wcet * 10 / 3, wcet * 10 * 8 / 10);
+	busy_wait(ms(rng));
+}
+
+void task0()
+{
+	job(1);
+}
+
+void task1()
+{
+	job(2);
+}
+
+void task2()
+{
+	job(1);
+}
+
+void task3()
+{
+	job(3);
+
+	if (std::bernoulli_distribution(0.4)(rng))
+		exec.ap_task_request();
+}
+
+void task4()
+{
+	job(1);
+}
+
+void ap_task()
+{
+	job(2);
+}
+
+int main(int argc, char * argv[])
+{
+	busy_wait_init();
+
+	exec.set_periodic_task(0, task0, 1); // tau_1
+	exec.set_periodic_task(1, task1, 2); // tau_2
+	exec.set_sliced_task(2, {task2, task3, task4}, {1, 3, 1}); // tau_3 (tau_3,1 tau_3,2 tau_3,3)
+
+	exec.set_aperiodic_task(ap_task, 2);
+
+	exec.add_frame({0,1,2});
+	exec.add_frame({0,2});
+	exec.add_frame({0,1});
+	exec.add_frame({0,1});
+	exec.add_frame({0,1,2});
+
+	std::string mode = argc > 2 ? argv[1] : "";
+	if (mode == "record")
+		exec.set_trace_record(argv[2]);
+	else if (mode == "replay" || mode == "replay-bodies")
+	{
+		if (!exec.set_trace_replay(argv[2], mode == "replay"))
+			return 1;
+	}
+	else if (argc > 1)
+	{
+		std::cerr << "usage: " << argv[0] << " [record <trace> | replay <trace> | replay-bodies <trace>]" << std::endl;
+		return 1;
+	}
+
+	exec.set_verbose(false);
+	exec.run(20);
+
+	Executive::exec_stats stats = exec.get_stats();
+	std::chrono::duration<double, std::milli> ap_mean(stats.total_ap_response);
+	if (stats.ap_jobs > 0)
+		ap_mean /= stats.ap_jobs;
+	std::chrono::duration<double, std::milli> ap_max(stats.max_ap_response);
+
+	std::ostringstream report;
+	report << "frames " << stats.frames << ", periodic misses " << stats.misses << ", aperiodic jobs " << stats.ap_jobs
+		<< " (misses " << stats.ap_misses << "), aperiodic response mean " << ap_mean.count() << " ms, max " << ap_max.count() << " ms" << std::endl;
+	std::cout << report.str();
+
+	return 0;
+}
@@ -0,0 +1,162 @@
+/**
+ * @file bench-ap-ring.cpp
+ *
+ * Round-trip latency of the inter-process aperiodic requests: a producer process posts requests in the
+ * executive's shared-memory ring, at random points of the frame, and waits for the completion of each one.
+ * The latency is measured with the ring drained only at the frame boundaries and with the eventfd doorbell.
+ *
+ * usage: bench-ap-ring [requests]
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <ctime>
+#include <random>
+#include <algorithm>
+
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "executive.h"
+#include "ap_ring.h"
+#include "busy_wait.h"
+
+static const unsigned int frame_length = 4;
+static const unsigned int unit_duration = 1; //ms
+static const char * ring_name = "/bench-ap-ring";
+
+static int64_t now_ns()
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+//PRODUCER PROCESS
+static void producer(unsigned int requests, bool doorbell)
+{
+	ap_ring * ring = nullptr;
+	for (int retry = 0; ring == nullptr && retry < 2000; ++retry)
+	{
+		ring = ap_ring_open(ring_name);
+		if (ring == nullptr)
+			usleep(1000);
+	}
+
+	if (ring == nullptr)
+	{
+		std::cerr << "Error opening the aperiodic request ring " << ring_name << std::endl;
+		return;
+	}
+
+	int bell = doorbell ? ap_ring_doorbell(ring) : -1;
+	if (doorbell && bell < 0)
+		std::cerr << "Doorbell not available (" << std::strerror(errno) << "): requests served at the frame boundaries" << std::endl;
+
+	std::mt19937 rng(42);
+	std::uniform_int_distribution<int> think(0, frame_length * unit_duration * 1000);
+
+	std::vector<int64_t> rtt;
+	int64_t send_total = 0;
+	unsigned int timeouts = 0;
+
+	for (uint64_t id = 1; id <= requests; ++id)
+	{
+		//arrivals spread over the phase of the frame
+		usleep(think(rng));
+
+		ap_request_data request = ap_request_data();
+		request.id = id;
+		request.type = 1;
+		request.deadline = 2;
+		request.size = sizeof(id);
+		std::memcpy(request.payload, &id, sizeof(id));
+
+		int64_t start = now_ns();
+		if (!ap_ring_send(ring, bell, request))
+			continue;
+		send_total += now_ns() - start;
+
+		while (!ring->is_complete(id) && now_ns() - request.sent_ns < 1000000000LL)
+			usleep(20);
+
+		if (!ring->is_complete(id))
+			++timeouts;
+		else
+			rtt.push_back(now_ns() - request.sent_ns);
+	}
+
+	std::sort(rtt.begin(), rtt.end());
+
+	double mean = 0;
+	for (auto & t: rtt)
+		mean += t;
+	if (!rtt.empty())
+		mean /= rtt.size();
+
+	auto pct = [&rtt](double p) { return rtt.empty() ? 0 : rtt[std::min(rtt.size() - 1, (size_t) (p * rtt.size()))] / 1000.0; };
+
+	std::ostringstream result;
+	result << std::fixed << std::setprecision(2)
+		<< (doorbell ? "doorbell      " : "frame boundary") << "  " << std::setw(8) << rtt.size()
+		<< "  " << std::setw(12) << (rtt.empty() ? 0 : send_total / (double) rtt.size())
+		<< "  " << std::setw(13) << mean / 1000.0 << "  " << std::setw(12) << pct(0.5)
+		<< "  " << std::setw(12) << pct(0.99) << "  " << std::setw(12) << (rtt.empty() ? 0 : rtt.back() / 1000.0)
+		<< "  " << std::setw(8) << timeouts;
+	std::cout << result.str() << std::flush;
+
+	if (bell >= 0)
+		close(bell);
+	ap_ring_close(ring);
+}
+
+int main(int argc, char * argv[])
+{
+	unsigned int requests = argc > 1 ? std::atoi(argv[1]) : 200;
+
+	busy_wait_init();
+
+	std::cout << "mode            requests  send_mean(ns)  rtt_mean(us)  rtt_p50(us)  rtt_p99(us)  rtt_max(us)  timeouts  ap_misses" << std::endl;
+
+	for (bool doorbell: {false, true})
+	{
+		shm_unlink(ring_name);
+
+		//the producer is forked before the executive creates its threads
+		pid_t pid = fork();
+		if (pid == 0)
+		{
+			producer(requests, doorbell);
+			_exit(0);
+		}
+
+		Executive exec(1, frame_length, unit_duration);
+		exec.set_verbose(false);
+		exec.set_periodic_task(0, []() { busy_wait(1 * unit_duration); }, 1);
+		exec.add_frame({0});
+
+		//short aperiodic jobs reading their request
+		volatile uint64_t last = 0;
+		exec.set_aperiodic_task([&exec, &last]() {
+			const ap_request_data & request = exec.ap_current_request();
+			uint64_t id;
+			std::memcpy(&id, request.payload, sizeof(id));
+			last = id;
+		}, 1);
+
+		exec.set_ap_ring(ring_name, 64, doorbell);
+
+		//enough frames for think time and round trip of every request
+		exec.run(requests * 3);
+
+		waitpid(pid, nullptr, 0);
+		std::cout << "  " << std::setw(9) << exec.get_stats().ap_misses << std::endl;
+	}
+
+	return 0;
+}
@@ -0,0 +1,132 @@
+/**
+ * @file bench-ap-server.cpp
+ *
+ * Comparison of the aperiodic service policies (see Executive::set_ap_server()) under the same request trace:
+ * the first periodic task requests an aperiodic job at the frames drawn from a seed, each with an execution time
+ * drawn from the same seed and carried in the request's payload. For each policy the benchmark reports the response
+ * time of the aperiodic jobs (from the request to the completion), the aperiodic misses (jobs still running at the
+ * next request), and the deadline misses and the response jitter (range of the response times) of the periodic tasks.
+ *
+ * usage: bench-ap-server [hyperperiods] [seed]
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <cstdlib>
+#include <random>
+#include <algorithm>
+#include <vector>
+#include <cstring>
+
+#include "executive.h"
+#include "busy_wait.h"
+
+static const unsigned int frame_length = 10;
+static const unsigned int unit_duration = 1; //ms
+
+struct trace
+{
+	std::vector<bool> request; //by job of tau_1
+	std::vector<unsigned int> duration; //ms, by request
+};
+
+static trace make_trace(unsigned int jobs, unsigned int seed)
+{
+	std::mt19937 rng(seed);
+	std::bernoulli_distribution arrival(0.35);
+	std::uniform_int_distribution<unsigned int> duration(1, 7);
+
+	trace t;
+	for (unsigned int j = 0; j < jobs; ++j)
+	{
+		t.request.push_back(arrival(rng));
+		t.duration.push_back(duration(rng));
+	}
+	return t;
+}
+
+static void run_policy(const char * name, Executive::ap_policy policy, unsigned int budget, unsigned int period,
+	const trace & t, unsigned int hyperperiods)
+{
+	Executive exec(3, frame_length, unit_duration);
+	exec.set_verbose(false);
+	exec.set_accounting(true);
+
+	//the request trace is replayed by tau_1, one entry per job
+	unsigned int job = 0, requests = 0;
+
+	exec.set_periodic_task(0, [&]() {
+		busy_wait(1);
+		if (job < t.request.size() && t.request[job])
+		{
+			ap_request_data request = ap_request_data();
+			request.size = sizeof(unsigned int);
+			std::memcpy(request.payload, &t.duration[job], sizeof(unsigned int));
+			++requests;
+			exec.ap_task_request(request);
+		}
+		++job;
+	}, 2);
+	exec.set_periodic_task(1, []() { busy_wait(2); }, 3);
+	exec.set_periodic_task(2, []() { busy_wait(1); }, 2);
+
+	exec.set_aperiodic_task([&]() {
+		//the job serves its own request (the ones arriving while it runs wait in the backlog)
+		unsigned int duration;
+		std::memcpy(&duration, exec.ap_current_request().payload, sizeof(duration));
+		busy_wait(duration);
+	}, 7);
+
+	exec.add_frame({0,1}); //slack 5
+	exec.add_frame({0,2}); //slack 6
+
+	exec.set_ap_server(policy, budget, period);
+	exec.run(hyperperiods);
+
+	Executive::exec_stats stats = exec.get_stats();
+	std::vector<std::chrono::nanoseconds> resp = exec.ap_response_times();
+	std::sort(resp.begin(), resp.end());
+
+	auto ms = [](std::chrono::nanoseconds t) { return std::chrono::duration<double, std::milli>(t).count(); };
+	auto pct = [&resp, &ms](double p) { return resp.empty() ? 0 : ms(resp[std::min(resp.size() - 1, (size_t) (p * resp.size()))]); };
+
+	std::chrono::nanoseconds jitter(0);
+	for (size_t i = 0; i < 3; ++i)
+	{
+		Executive::job_accounting a = exec.get_accounting(i);
+		jitter = std::max(jitter, a.max_response - a.min_response);
+	}
+
+	std::ostringstream result;
+	result << std::fixed << std::setprecision(2)
+		<< std::left << std::setw(16) << name << std::right
+		<< "  " << std::setw(8) << requests << "  " << std::setw(6) << stats.ap_jobs
+		<< "  " << std::setw(6) << stats.ap_misses
+		<< "  " << std::setw(10) << (stats.ap_jobs > 0 ? ms(stats.total_ap_response) / stats.ap_jobs : 0)
+		<< "  " << std::setw(9) << pct(0.5) << "  " << std::setw(9) << pct(0.99) << "  " << std::setw(9) << ms(stats.max_ap_response)
+		<< "  " << std::setw(10) << stats.misses << "  " << std::setw(13) << ms(jitter);
+	if (stats.degraded)
+		result << "  (degraded)";
+	std::cout << result.str() << std::endl;
+}
+
+int main(int argc, char * argv[])
+{
+	unsigned int hyperperiods = argc > 1 ? std::atoi(argv[1]) : 100;
+	unsigned int seed = argc > 2 ? std::atoi(argv[2]) : 1;
+
+	busy_wait_init();
+
+	//one job of tau_1 per frame
+	trace t = make_trace(hyperperiods * 2, seed);
+
+	std::cout << "policy            requests  served  misses  resp_mean  resp_p50  resp_p99  resp_max  p_misses  p_jitter(ms)" << std::endl;
+
+	run_policy("slack stealing", Executive::SLACK_STEALING, 0, 1, t, hyperperiods);
+	run_policy("background", Executive::BACKGROUND, 0, 1, t, hyperperiods);
+	run_policy("polling 4/2", Executive::POLLING, 4, 2, t, hyperperiods);
+	run_policy("deferrable 4/2", Executive::DEFERRABLE, 4, 2, t, hyperperiods);
+
+	return 0;
+}
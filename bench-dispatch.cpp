@@ -0,0 +1,150 @@
+/**
+ * @file bench-dispatch.cpp
+ * 
+ * Microbenchmark of the executive's dispatch path with the two task table layouts:
+ * - packed: one structure per task with dispatch state, condition variable, function and thread
+ *   (the former std::vector<task_data>), so neighbouring tasks share cache lines;
+ * - split: dispatch state in cache-line aligned slots, configuration in a separate array.
+ * The "executive" thread repeatedly releases every task and checks its completion (as at each frame start),
+ * while one worker per task, spread over the available cores, updates its own state.
+ * The time per executive pass is reported for both layouts.
+ * The structures are reduced models of the two layouts, not the Executive's own (private) ones: the benchmark
+ * isolates the cache traffic of the layout; the whole frame path is measured by bench-schedule.
+ * 
+ * usage: bench-dispatch [tasks] [passes]
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <cstdlib>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <chrono>
+
+#include "rt/affinity.h"
+#include "rt/mutex.h"
+
+enum thread_state {PENDING, IDLE, RUNNING};
+
+// former layout: hot and cold data of a task in the same structure
+struct packed_task
+{
+	std::function<void()> function;
+	unsigned int wcet;
+	std::thread thread;
+	int type;
+	std::atomic<int> state;
+	rt::condition_variable cond;
+	int id;
+	std::atomic<bool> miss;
+};
+
+// new layout: hot data in its own cache line, cold data in a separate array
+struct alignas(64) task_slot
+{
+	std::atomic<int> state;
+	std::atomic<bool> miss;
+	rt::condition_variable cond;
+};
+
+struct task_config
+{
+	std::function<void()> function;
+	unsigned int wcet;
+	std::thread thread;
+	int type;
+	int id;
+};
+
+template <class Hot>
+static double run(std::vector<Hot> & hot, unsigned long passes)
+{
+	std::atomic<bool> done(false);
+	std::vector<std::thread> workers;
+	unsigned int cores = std::max(1u, std::thread::hardware_concurrency());
+
+	//workers: take their release and complete it, touching only their own state
+	for (size_t i = 0; i < hot.size(); ++i)
+	{
+		workers.emplace_back([&hot, &done, i]()
+		{
+			while (!done.load(std::memory_order_relaxed))
+			{
+				int expected = PENDING;
+				if (hot[i].state.compare_exchange_weak(expected, RUNNING, std::memory_order_acquire))
+					hot[i].state.store(IDLE, std::memory_order_release);
+			}
+		});
+
+		rt::affinity aff;
+		aff.set((i + 1) % cores);
+		rt::set_affinity(workers.back(), aff);
+	}
+
+	auto start = std::chrono::steady_clock::now();
+
+	//executive: miss check and release of every task
+	for (unsigned long p = 0; p < passes; ++p)
+	{
+		for (auto & t: hot)
+		{
+			bool miss = t.state.load(std::memory_order_acquire) != IDLE;
+			t.miss.store(miss, std::memory_order_relaxed);
+		}
+		for (auto & t: hot)
+		{
+			int expected = IDLE;
+			t.state.compare_exchange_strong(expected, PENDING, std::memory_order_release);
+		}
+	}
+
+	std::chrono::duration<double, std::nano> elapsed(std::chrono::steady_clock::now() - start);
+
+	done = true;
+	for (auto & w: workers)
+		w.join();
+
+	return elapsed.count() / passes;
+}
+
+template <class Hot>
+static void init(std::vector<Hot> & hot)
+{
+	for (auto & t: hot)
+	{
+		t.state = IDLE;
+		t.miss = false;
+	}
+}
+
+int main(int argc, char * argv[])
+{
+	size_t tasks = argc > 1 ? std::atoi(argv[1]) : 8;
+	unsigned long passes = argc > 2 ? std::atol(argv[2]) : 200000;
+
+	rt::affinity aff;
+	aff.set(0);
+	rt::this_thread::set_affinity(aff);
+
+	std::vector<packed_task> packed(tasks);
+	init(packed);
+
+	std::vector<task_slot> slots(tasks);
+	std::vector<task_config> config(tasks);
+	init(slots);
+
+	double packed_ns = run(packed, passes);
+	double split_ns = run(slots, passes);
+
+	std::ostringstream out;
+	out << std::fixed << std::setprecision(1)
+		<< "tasks " << tasks << ", cores " << std::thread::hardware_concurrency() << std::endl
+		<< "packed layout (" << sizeof(packed_task) << " bytes/task): " << packed_ns << " ns per pass" << std::endl
+		<< "split layout (" << sizeof(task_slot) << " + " << sizeof(task_config) << " bytes/task): " << split_ns << " ns per pass" << std::endl;
+	std::cout << out.str();
+
+	return 0;
+}
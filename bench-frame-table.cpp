@@ -0,0 +1,127 @@
+/**
+ * @file bench-frame-table.cpp
+ *
+ * Frame table benchmark: a schedule with a long hyperperiod is stored in the former layout (one vector of
+ * task ids per frame and a separate vector of slack times) and in the flat frame_table, with and without
+ * compression. For each layout it reports the memory used and the time to read a frame at its start,
+ * with the caches polluted between the frames as the tasks' jobs would do.
+ *
+ * usage: bench-frame-table [frames] [distinct frame patterns]
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <cstdlib>
+#include <chrono>
+#include <random>
+#include <memory>
+
+#include "frame_table.h"
+
+static const size_t num_tasks = 32;
+static const size_t pollution_bytes = 8 << 20; //larger than the last level cache
+
+static std::vector<char> pollution(pollution_bytes);
+static volatile size_t sink; //keeps the reads
+
+static void pollute()
+{
+	for (size_t i = 0; i < pollution.size(); i += 64)
+		++pollution[i];
+}
+
+//time to read the tasks and the slack time of the frames, one frame per cache pollution
+template <typename Read>
+static double frame_start_ns(size_t frames, Read read)
+{
+	std::chrono::nanoseconds total(0);
+
+	for (size_t f = 0; f < frames; ++f)
+	{
+		pollute();
+
+		auto start = std::chrono::steady_clock::now();
+		sink = read(f);
+		total += std::chrono::steady_clock::now() - start;
+	}
+
+	return (double) total.count() / frames;
+}
+
+int main(int argc, char * argv[])
+{
+	size_t frames = argc > 1 ? std::atol(argv[1]) : 20000;
+	size_t patterns = argc > 2 ? std::atol(argv[2]) : 64;
+
+	std::mt19937 rng(42);
+	std::uniform_int_distribution<size_t> task(0, num_tasks - 1);
+	std::uniform_int_distribution<size_t> length(1, 8);
+	std::uniform_int_distribution<size_t> pattern(0, patterns - 1);
+	std::uniform_int_distribution<size_t> noise(16, 256);
+
+	std::vector< std::vector<size_t> > shapes(patterns);
+	for (auto & shape: shapes)
+	{
+		shape.resize(length(rng));
+		for (auto & id: shape)
+			id = task(rng);
+	}
+
+	//former layout: one heap block per frame, allocated among the other data of the application
+	std::vector< std::vector<size_t> > nested;
+	std::vector<size_t> slack_times;
+	std::vector< std::unique_ptr<char[]> > other;
+	frame_table table;
+
+	size_t nested_bytes = 0;
+	for (size_t f = 0; f < frames; ++f)
+	{
+		const std::vector<size_t> & frame = shapes[pattern(rng)];
+		unsigned int slack = 10 - frame.size();
+
+		nested.push_back(frame);
+		slack_times.push_back(slack);
+		other.emplace_back(new char[noise(rng)]);
+
+		table.push_back(frame, slack);
+
+		nested_bytes += frame.capacity() * sizeof(size_t) + 16; //allocator header
+	}
+	nested_bytes += sizeof(nested) + nested.capacity() * sizeof(std::vector<size_t>) + slack_times.capacity() * sizeof(size_t);
+
+	std::cout << "frames " << frames << ", distinct frames " << patterns << std::endl;
+	std::cout << "layout            memory(KiB)  bytes/frame  frame_start(ns)" << std::endl;
+
+	auto report = [frames](const char * layout, size_t bytes, double ns)
+	{
+		std::ostringstream row;
+		row << std::fixed << std::setprecision(2) << std::left << std::setw(16) << layout << std::right
+			<< "  " << std::setw(11) << bytes / 1024.0 << "  " << std::setw(11) << (double) bytes / frames
+			<< "  " << std::setw(15) << ns;
+		std::cout << row.str() << std::endl;
+	};
+
+	report("nested vectors", nested_bytes, frame_start_ns(frames, [&](size_t f)
+	{
+		size_t sum = slack_times[f];
+		for (auto & id: nested[f])
+			sum += id;
+		return sum;
+	}));
+
+	auto read_table = [&table](size_t f)
+	{
+		size_t sum = table.slack(f);
+		for (auto & id: table[f])
+			sum += id;
+		return sum;
+	};
+
+	report("frame_table", table.memory(), frame_start_ns(frames, read_table));
+
+	table.compress();
+	report("compressed", table.memory(), frame_start_ns(frames, read_table));
+
+	return 0;
+}
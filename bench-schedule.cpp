@@ -0,0 +1,134 @@
+/**
+ * @file bench-schedule.cpp
+ * 
+ * Schedulability benchmark on random task sets: for each task count, utilization and kind of periods
+ * it reports the schedule construction time, the ratio of feasible sets and the slack distribution;
+ * a few feasible sets are also executed to measure the executive's runtime overhead.
+ * 
+ * usage: bench-schedule [sets per configuration] [executed sets per configuration]
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <cstdlib>
+#include <algorithm>
+
+#include "executive.h"
+#include "taskset.h"
+#include "busy_wait.h"
+
+static const unsigned int frame_length = 10;
+static const unsigned int unit_duration = 1; //ms
+
+int main(int argc, char * argv[])
+{
+	unsigned int sets = argc > 1 ? std::atoi(argv[1]) : 250;
+	unsigned int runs = argc > 2 ? std::atoi(argv[2]) : 1;
+
+	busy_wait_init();
+
+	std::mt19937 rng(42);
+
+	const size_t task_counts[] = {4, 8, 16, 32};
+	const double utilizations[] = {0.3, 0.5, 0.7, 0.9};
+	const period_set period_sets[] = {HARMONIC, NON_HARMONIC};
+
+	std::cout << std::fixed << std::setprecision(2);
+	std::cout << "periods       tasks  util  feasible  build_mean(us)  build_max(us)  slack_mean  slack_p10  slack_min"
+		<< "  latency_mean(us)  latency_max(us)  dispatch_mean(us)  dispatch_max(us)  misses" << std::endl;
+
+	for (auto periods: period_sets)
+	{
+		for (auto n: task_counts)
+		{
+			for (auto u: utilizations)
+			{
+				unsigned int feasible = 0;
+				unsigned int executed = 0;
+				double build_total = 0, build_max = 0;
+				std::vector<unsigned int> slacks;
+				Executive::exec_stats run_stats = Executive::exec_stats();
+
+				for (unsigned int k = 0; k < sets; ++k)
+				{
+					std::vector<task_spec> tasks = generate_taskset(n, u, periods, frame_length, rng);
+
+					Executive exec(n, frame_length, unit_duration);
+					exec.set_verbose(false);
+
+					//synthetic jobs: half of their budget of cpu time
+					auto body = [](size_t, unsigned int budget) { busy_wait(budget * unit_duration / 2); };
+
+					auto start = std::chrono::steady_clock::now();
+					bool ok = configure_executive(exec, tasks, frame_length, body);
+					std::chrono::duration<double, std::micro> build(std::chrono::steady_clock::now() - start);
+
+					build_total += build.count();
+					build_max = std::max(build_max, build.count());
+
+					if (!ok)
+						continue;
+
+					++feasible;
+					for (size_t f = 0; f < exec.num_frames(); ++f)
+						slacks.push_back(exec.slack_time(f));
+
+					if (executed < runs)
+					{
+						exec.set_aperiodic_task([]() {}, 0);
+						exec.run(1);
+
+						Executive::exec_stats s = exec.get_stats();
+						run_stats.frames += s.frames;
+						run_stats.misses += s.misses;
+						run_stats.total_latency += s.total_latency;
+						run_stats.total_dispatch += s.total_dispatch;
+						run_stats.max_latency = std::max(run_stats.max_latency, s.max_latency);
+						run_stats.max_dispatch = std::max(run_stats.max_dispatch, s.max_dispatch);
+						run_stats.degraded = run_stats.degraded || s.degraded;
+						++executed;
+					}
+				}
+
+				std::sort(slacks.begin(), slacks.end());
+				double slack_mean = 0;
+				for (auto s: slacks)
+					slack_mean += s;
+				if (!slacks.empty())
+					slack_mean /= slacks.size();
+
+				std::ostringstream row;
+				row << std::fixed << std::setprecision(2)
+					<< std::left << std::setw(14) << (periods == HARMONIC ? "harmonic" : "non-harmonic") << std::right
+					<< std::setw(5) << n << std::setw(6) << u
+					<< std::setw(10) << 100.0 * feasible / sets << "%"
+					<< std::setw(15) << build_total / sets << std::setw(15) << build_max;
+
+				if (slacks.empty())
+					row << std::setw(12) << "-" << std::setw(11) << "-" << std::setw(11) << "-";
+				else
+					row << std::setw(12) << slack_mean << std::setw(11) << slacks[slacks.size() / 10] << std::setw(11) << slacks.front();
+
+				if (run_stats.frames == 0)
+				{
+					row << std::setw(18) << "-" << std::setw(17) << "-" << std::setw(19) << "-" << std::setw(18) << "-" << std::setw(8) << "-";
+				}
+				else
+				{
+					row << std::setw(18) << std::chrono::duration<double, std::micro>(run_stats.total_latency).count() / run_stats.frames
+						<< std::setw(17) << std::chrono::duration<double, std::micro>(run_stats.max_latency).count()
+						<< std::setw(19) << std::chrono::duration<double, std::micro>(run_stats.total_dispatch).count() / run_stats.frames
+						<< std::setw(18) << std::chrono::duration<double, std::micro>(run_stats.max_dispatch).count()
+						<< std::setw(8) << run_stats.misses;
+					if (run_stats.degraded)
+						row << " (degraded)";
+				}
+
+				std::cout << row.str() << std::endl;
+			}
+		}
+	}
+
+	return 0;
+}
@@ -10,7 +10,7 @@ static unsigned int busy_wait_impl(unsigned int max_millisec, unsigned int max_c
 	auto stop_time = std::chrono::high_resolution_clock::now() + std::chrono::milliseconds(max_millisec);
 
 	while (cycles < max_cycles && std::chrono::high_resolution_clock::now() < stop_time)
-		++cycles;
+		cycles = cycles + 1;
 		
 	return cycles;
 }
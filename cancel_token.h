@@ -0,0 +1,33 @@
+/**
+ * @file cancel_token.h
+ */
+
+#ifndef CANCEL_TOKEN_H
+#define CANCEL_TOKEN_H
+
+#include <atomic>
+
+/*
+	Cooperative cancellation of a job (see Executive::set_aperiodic_task() and Executive::set_periodic_task()):
+	the executive signals the token when the job's deadline has passed, the body checks it at its preemption points
+	(e.g. between the iterations of its loops) and returns early, leaving the cpu to the fresh jobs.
+	The token is cleared at each release of the task. A cancelled job is not complete: its LET outputs are not published.
+*/
+class cancel_token
+{
+	public:
+		cancel_token() : flag(false) {}
+
+		bool cancelled() const { return flag.load(std::memory_order_relaxed); }
+		explicit operator bool() const { return cancelled(); }
+
+	private:
+		void cancel() { flag.store(true, std::memory_order_relaxed); }
+		void reset() { flag.store(false, std::memory_order_relaxed); }
+
+		std::atomic<bool> flag;
+
+		friend class Executive;
+};
+
+#endif
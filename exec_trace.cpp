@@ -0,0 +1,162 @@
+/**
+ * @file exec_trace.cpp
+ */
+
+#include <cassert>
+#include <cstring>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <limits>
+
+#include "exec_trace.h"
+
+static const char trace_magic[4] = {'E', 'X', 'T', 'R'};
+static const uint32_t trace_version = 1;
+
+exec_trace::exec_trace() : tasks(0), frame_duration(0), added(0), next(0)
+{
+}
+
+void exec_trace::reset(size_t num_tasks, std::chrono::nanoseconds frame, size_t capacity)
+{
+	assert(num_tasks < std::numeric_limits<uint16_t>::max()); //It fails if the task ids do not fit the records
+	assert(capacity > 0); //It fails if the ring has no records
+
+	tasks = num_tasks;
+	frame_duration = frame;
+	records.assign(capacity, record());
+	added = 0;
+}
+
+void exec_trace::add_arrival(unsigned long frame, std::chrono::nanoseconds offset)
+{
+	records[added++ % records.size()] = {(uint32_t) frame, ARRIVAL, 0, offset.count()};
+}
+
+void exec_trace::add_job(unsigned long frame, size_t task_id, std::chrono::nanoseconds cpu)
+{
+	records[added++ % records.size()] = {(uint32_t) frame, JOB, (uint16_t) task_id, cpu.count()};
+}
+
+bool exec_trace::save(const std::string & path) const
+{
+	std::ofstream out(path, std::ios::binary | std::ios::trunc);
+	if (!out)
+	{
+		std::cerr << "Error opening the trace " << path << std::endl;
+		return false;
+	}
+
+	header h;
+	std::memcpy(h.magic, trace_magic, sizeof(h.magic));
+	h.version = trace_version;
+	h.num_tasks = tasks;
+	h.reserved = 0;
+	h.frame = frame_duration.count();
+	h.records = size();
+
+	//from the oldest record of the ring
+	size_t first = added > records.size() ? added % records.size() : 0;
+	out.write(reinterpret_cast<const char *>(&h), sizeof(h));
+	out.write(reinterpret_cast<const char *>(records.data() + first), (size() - first) * sizeof(record));
+	out.write(reinterpret_cast<const char *>(records.data()), first * sizeof(record));
+
+	if (!out)
+	{
+		std::cerr << "Error writing the trace " << path << std::endl;
+		return false;
+	}
+	return true;
+}
+
+bool exec_trace::load(const std::string & path)
+{
+	std::ifstream in(path, std::ios::binary);
+	if (!in)
+	{
+		std::cerr << "Error opening the trace " << path << std::endl;
+		return false;
+	}
+
+	header h;
+	if (!in.read(reinterpret_cast<char *>(&h), sizeof(h)) || std::memcmp(h.magic, trace_magic, sizeof(h.magic)) != 0 || h.version != trace_version)
+	{
+		std::cerr << path << ": not a trace of the executive" << std::endl;
+		return false;
+	}
+
+	records.resize(h.records);
+	if (!in.read(reinterpret_cast<char *>(records.data()), records.size() * sizeof(record)))
+	{
+		std::cerr << path << ": truncated trace" << std::endl;
+		return false;
+	}
+
+	tasks = h.num_tasks;
+	frame_duration = std::chrono::nanoseconds(h.frame);
+	added = records.size();
+
+	//the jobs of a task complete in the order of their releases, the arrivals are recorded in frame order
+	arrivals.clear();
+	jobs.assign(tasks + 1, std::vector<record>());
+	for (auto & r: records)
+	{
+		if (r.type == ARRIVAL)
+			arrivals.push_back(r);
+		else if (r.task <= tasks)
+			jobs[r.task].push_back(r);
+	}
+
+	next = 0;
+	job_next.assign(tasks + 1, 0);
+	return true;
+}
+
+size_t exec_trace::num_tasks() const
+{
+	return tasks;
+}
+
+std::chrono::nanoseconds exec_trace::frame() const
+{
+	return frame_duration;
+}
+
+size_t exec_trace::size() const
+{
+	return std::min<size_t>(added, records.size());
+}
+
+unsigned long exec_trace::overwritten() const
+{
+	return added > records.size() ? added - records.size() : 0;
+}
+
+bool exec_trace::next_arrival(unsigned long frame, std::chrono::nanoseconds & offset)
+{
+	while (next < arrivals.size() && arrivals[next].frame < frame)
+		++next; //frames not executed in the replay
+
+	if (next == arrivals.size() || arrivals[next].frame != frame)
+		return false;
+
+	offset = std::chrono::nanoseconds(arrivals[next++].value);
+	return true;
+}
+
+bool exec_trace::job_time(size_t task_id, unsigned long frame, std::chrono::nanoseconds & cpu)
+{
+	assert(task_id < jobs.size()); //It fails if task_id is not correct (out of range)
+
+	const std::vector<record> & task_jobs = jobs[task_id];
+	size_t & i = job_next[task_id];
+	while (i < task_jobs.size() && task_jobs[i].frame < frame)
+		++i; //jobs released in the recording only
+
+	if (i == task_jobs.size() || task_jobs[i].frame != frame)
+		return false;
+
+	cpu = std::chrono::nanoseconds(task_jobs[i++].value);
+	return true;
+}
@@ -0,0 +1,84 @@
+/**
+ * @file exec_trace.h
+ */
+
+#ifndef EXEC_TRACE_H
+#define EXEC_TRACE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <chrono>
+#include <string>
+#include <vector>
+
+/*
+	Compact binary trace of a run of the executive (see Executive::set_trace_record() and set_trace_replay()):
+	a header with the task set's size and the frame duration, followed by 16-byte records of
+	- the aperiodic arrivals: frame count of the release and offset of the request from the start of that frame;
+	- the jobs: frame count of the release, task id (num_tasks for the aperiodic task) and cpu time of the job's body.
+	The records are kept during the run in a ring of fixed capacity, allocated before the run, so that recording never
+	allocates: when it is full the oldest records are overwritten (and counted), and the trace written when the run
+	ends keeps the last ones. A loaded trace is indexed by task, so that
+	the replay finds the arrivals of a frame and the cpu time of a job in O(1) (the frames only advance).
+*/
+class exec_trace
+{
+	public:
+		enum record_type : uint16_t {ARRIVAL, JOB};
+
+		struct record
+		{
+			uint32_t frame;
+			uint16_t type;
+			uint16_t task;
+			int64_t value; //ns: offset (ARRIVAL) or cpu time (JOB)
+		};
+
+		exec_trace();
+
+		/* Recording: empties the trace, with a ring of the given number of records */
+		void reset(size_t num_tasks, std::chrono::nanoseconds frame, size_t capacity);
+
+		void add_arrival(unsigned long frame, std::chrono::nanoseconds offset);
+		void add_job(unsigned long frame, size_t task_id, std::chrono::nanoseconds cpu);
+
+		/* Write and read the trace; false (printing the error) if the file cannot be written or read */
+		bool save(const std::string & path) const;
+		bool load(const std::string & path);
+
+		size_t num_tasks() const;
+		std::chrono::nanoseconds frame() const;
+		size_t size() const;
+		unsigned long overwritten() const; //recording: records lost because the ring was full
+
+		/*
+			Replay: next arrival of the given frame (false when there are no more); cpu time of the job of a task
+			released at the given frame (false if not in the trace). Each task must be asked by one thread only.
+		*/
+		bool next_arrival(unsigned long frame, std::chrono::nanoseconds & offset);
+		bool job_time(size_t task_id, unsigned long frame, std::chrono::nanoseconds & cpu);
+
+	private:
+		struct header
+		{
+			char magic[4];
+			uint32_t version;
+			uint32_t num_tasks;
+			uint32_t reserved;
+			int64_t frame; //ns
+			uint64_t records;
+		};
+
+		size_t tasks;
+		std::chrono::nanoseconds frame_duration;
+		std::vector<record> records;
+		unsigned long added; //recording: records added to the ring (the next one goes to added % capacity)
+
+		//replay: indexes of the loaded records, with their cursors
+		std::vector<record> arrivals;
+		size_t next;
+		std::vector<std::vector<record>> jobs;
+		std::vector<size_t> job_next;
+};
+
+#endif
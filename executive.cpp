@@ -5,378 +5,2621 @@
  */
 
 #include <cassert>
+#include <climits>
+#include <cmath>
+#include <ctime>
+#include <algorithm>
+#include <memory>
 #include <iostream>
 #include <sstream>
 
+#include <sys/mman.h>
+#include <sys/eventfd.h>
+#include <poll.h>
+#include <pthread.h>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
 #include "executive.h"
 
 #include "rt/priority.h"
 #include "rt/affinity.h"
 
 Executive::Executive(size_t num_tasks, unsigned int frame_length, unsigned int unit_duration)
-	: p_tasks(num_tasks), frame_length(frame_length), unit_time(unit_duration), ap_request(false)
+	: p_tasks(num_tasks), slots(num_tasks + 1), frame_length(frame_length), unit_time(unit_duration), ap_request(false), ap_local_request(),
+	  deadline_server(false), ap_budget(0), recovery_budget(0), max_recoveries(0), hi_mode(false), accounting(false), perf(false), force_unprivileged(false), degraded(false), cpus("1"), max_prio(), verbose(true), stop(false), max_frames(0), stats(), profile_hyperperiods(0), profile_margin(0), clock(&default_clock), late_policy(CATCH_UP), late_tolerance(1), shm(nullptr),
+	  ring_capacity(64), ring_doorbell(false), ring_mode(0600), ring(nullptr), doorbell_fd(-1), ap_current(), ap_from_ring(false), ap_deadline_frame(0), ap_overdue(false), ap_backlog(AP_BACKLOG), ap_backlog_head(0), ap_backlog_size(0), ap_server(SLACK_STEALING), server_budget(0), server_period(1), server_left(0), faults(nullptr), pool(nullptr), trace_capacity(0), replaying(false), replay_synthetic(false)
 {
+	for (size_t id = 0; id < num_tasks; ++id)
+		p_tasks[id].slot = &slots[id];
+	ap_task.slot = &slots.back();
 }
 
 void Executive::set_periodic_task(size_t task_id, std::function<void()> periodic_task, unsigned int wcet)
+{
+	set_periodic_task(task_id, periodic_task, wcet, 0);
+}
+
+void Executive::set_periodic_task(size_t task_id, std::function<void()> periodic_task, unsigned int wcet, unsigned int period, criticality level)
 {
 	assert(task_id < p_tasks.size()); //It fails if task_id is not correct (out of range)
 	
 	p_tasks[task_id].function = periodic_task;
 	p_tasks[task_id].wcet = wcet;
-	p_tasks[task_id].miss = false;
-	p_tasks[task_id].state = IDLE;
+	p_tasks[task_id].period = period;
+	p_tasks[task_id].level = level;
+	p_tasks[task_id].releases = 0;
+	slots[task_id].next_slice = 0;
+	slots[task_id].job_done = false;
+	slots[task_id].job_cancelled = false;
+	slots[task_id].miss = false;
+	slots[task_id].miss_count = 0;
+	slots[task_id].sample_count = 0;
+	slots[task_id].state = IDLE;
 	p_tasks[task_id].type = PERIODIC;
 	p_tasks[task_id].id = task_id;
+	slots[task_id].tid = 0;
+	p_tasks[task_id].dl_budget = std::chrono::nanoseconds::zero();
+}
+
+void Executive::set_periodic_task(size_t task_id, std::function<void(const cancel_token &)> periodic_task, unsigned int wcet, unsigned int period, criticality level)
+{
+	assert(task_id < p_tasks.size()); //It fails if task_id is not correct (out of range)
+
+	const cancel_token & token = slots[task_id].cancel;
+	set_periodic_task(task_id, [periodic_task, &token]() { periodic_task(token); }, wcet, period, level);
+}
+
+void Executive::set_criticality(size_t task_id, criticality level)
+{
+	assert(task_id < p_tasks.size()); //It fails if task_id is not correct (out of range)
+
+	p_tasks[task_id].level = level;
+}
+
+void Executive::set_sliced_task(size_t task_id, std::vector< std::function<void()> > slices, std::vector<unsigned int> wcets, unsigned int period)
+{
+	assert(!slices.empty() && slices.size() == wcets.size()); //It fails if a slice has no wcet
+
+	unsigned int tot_wcet = 0;
+	for (auto & w: wcets)
+	{
+		assert(w <= frame_length); //It fails if a slice does not fit a frame
+		tot_wcet += w;
+	}
+
+	set_periodic_task(task_id, std::function<void()>(), tot_wcet, period);
+
+	p_tasks[task_id].slices = slices;
+	p_tasks[task_id].slice_wcets = wcets;
+}
+
+void Executive::set_resumable_task(size_t task_id, std::function<bool(unsigned int)> body, unsigned int wcet, unsigned int period)
+{
+	assert(period > 0); //It fails if the period is missing: budgets are chosen by build_schedule()
+
+	set_periodic_task(task_id, std::function<void()>(), wcet, period);
+
+	p_tasks[task_id].resumable = body;
 }
 
 void Executive::set_aperiodic_task(std::function<void()> aperiodic_task, unsigned int wcet)
 {
  	ap_task.function = aperiodic_task;
  	ap_task.wcet = wcet;
-	ap_task.state = IDLE;
+	ap_task.slot->state = IDLE;
+	ap_task.slot->sample_count = 0;
+	ap_task.type = APERIODIC;
+	ap_task.slot->tid = 0;
+	ap_task.dl_budget = std::chrono::nanoseconds::zero();
+}
+
+void Executive::set_aperiodic_task(std::function<void(const cancel_token &)> aperiodic_task, unsigned int wcet)
+{
+	const cancel_token & token = ap_task.slot->cancel;
+	set_aperiodic_task([aperiodic_task, &token]() { aperiodic_task(token); }, wcet);
+}
+		
+void Executive::set_aperiodic_coroutine(std::function<ap_coroutine(ap_context &)> aperiodic_task, unsigned int wcet)
+{
+	ap_body = aperiodic_task;
+	ap_task.wcet = wcet;
 	ap_task.type = APERIODIC;
 }
 		
 void Executive::add_frame(std::vector<size_t> frame)
 {
 	for (auto & id: frame)
+	{
 		assert(id < p_tasks.size()); //It fails if task_id is not correct (out of range)
-	
-	frames.push_back(frame);
+		assert(!p_tasks[id].resumable || !p_tasks[id].slice_wcets.empty()); //It fails if a resumable task is not scheduled by build_schedule()
+	}
 
 	unsigned int tot_wcet = 0;
 	for (size_t i = 0; i < frame.size(); i++)
 	{
-		tot_wcet += p_tasks[frame[i]].wcet;
+		const task_data & task = p_tasks[frame[i]];
+
+		if (task.slice_wcets.empty())
+		{
+			tot_wcet += task.wcet;
+		}
+		else
+		{
+			//the k-th release of a sliced task in the frames executes its k-th slice
+			tot_wcet += task.slice_wcets[task.releases % task.slice_wcets.size()];
+		}
+	}
+
+	assert(tot_wcet <= frame_length); //It fails if the frame is overloaded
+
+	for (auto & id: frame)
+	{
+		if (!p_tasks[id].slice_wcets.empty())
+			p_tasks[id].release_frames.push_back(frames.size());
+		++p_tasks[id].releases;
 	}
 
-	slack_times.push_back(frame_length-tot_wcet); //Vector's construction that contains pre-computed slack-times
+	frames.push_back(frame, frame_length-tot_wcet); //the frame's tasks with the pre-computed slack time
+	dags.emplace_back();
 }
 
-//START RUN
-void Executive::run()
+void Executive::add_frame(std::vector<size_t> frame, std::vector<std::pair<size_t, size_t>> edges)
 {
-	//EXECUTIVE THREAD INITIALIZATION
-	rt::priority exec_prio(rt::priority::rt_max);
-	rt::affinity aff("1");
-
+	assert(p_tasks.size() <= 64); //It fails if the tasks do not fit the precedence masks
 
-	//PERIODIC TASK THREAD INITIALIZATION
-	for (size_t id = 0; id < p_tasks.size(); ++id)
+	size_t n = frame.size();
+	std::vector<size_t> pos(p_tasks.size(), n);
+	for (size_t i = 0; i < n; i++)
 	{
-		
-		assert(p_tasks[id].function); //It fails if set_periodic_task() has not been invoked for this id
-		
-		p_tasks[id].thread = std::thread(&Executive::task_function, std::ref(p_tasks[id]), std::ref(state_mutex));
-
+		assert(frame[i] < p_tasks.size()); //It fails if task_id is not correct (out of range)
+		assert(pos[frame[i]] == n); //It fails if a task has two jobs in the frame
+		assert(!p_tasks[frame[i]].resumable || !p_tasks[frame[i]].slice_wcets.empty()); //It fails if a resumable task is not scheduled by build_schedule()
+		pos[frame[i]] = i;
 	}
-	
 
-	//APERIODIC TASK THREAD INITIALIZATION
-	assert(ap_task.function); // It fails if set_aperiodic_task() has not been invoked
-	
-	ap_task.thread = std::thread(&Executive::task_function, std::ref(ap_task), std::ref(state_mutex));
-	rt::priority a_prio(rt::priority::rt_min);
+	std::vector<uint64_t> preds(n, 0), succs(n, 0);
+	for (auto & e: edges)
+	{
+		assert(e.first < p_tasks.size() && e.second < p_tasks.size() && pos[e.first] < n && pos[e.second] < n); //It fails if an edge is not between tasks of the frame
+		assert(pos[e.first] < pos[e.second]); //It fails if the frame is not in a topological order of the edges
+		preds[pos[e.second]] |= 1ULL << e.first;
+		succs[pos[e.first]] |= 1ULL << e.second;
+	}
 
-	set_thread_priority(ap_task.thread, a_prio);
-	rt::set_affinity(ap_task.thread, aff);
-	
-	std::thread exec_thread(&Executive::exec_function, this);
+	//wcet of each job: the k-th release of a sliced task in the frames executes its k-th slice
+	std::vector<unsigned int> wcet(n);
+	for (size_t i = 0; i < n; i++)
+	{
+		const task_data & task = p_tasks[frame[i]];
+		wcet[i] = task.slice_wcets.empty() ? task.wcet : task.slice_wcets[task.releases % task.slice_wcets.size()];
+	}
 
-	set_thread_priority(exec_thread, exec_prio);
-	rt::set_affinity(exec_thread, aff);
-	
-	
-	//FINAL JOIN
-	exec_thread.join();
-	
-	ap_task.thread.join();
-	
-	for (auto & pt: p_tasks)
-		pt.thread.join();
-}
+	//longest path from each job to the end of the frame (reverse topological order)
+	std::vector<unsigned int> level(n, 0);
+	for (size_t i = n; i-- > 0; )
+	{
+		level[i] = wcet[i];
+		for (uint64_t s = succs[i]; s != 0; s &= s - 1)
+			level[i] = std::max(level[i], wcet[i] + level[pos[__builtin_ctzll(s)]]);
+	}
 
-void Executive::ap_task_request() 
-{
-	std::unique_lock<std::mutex> lock(ap_request_mutex);
-    ap_request = true;
-}
+	std::vector<unsigned int> cpu_ids;
+	for (size_t c = 0; c < cpus.size(); c++)
+		if (cpus.test(c))
+			cpu_ids.push_back(c);
 
-void Executive::set_thread_priority(std::thread &th, rt::priority &p)
-{
-	try
-		{
-			rt::set_priority(th,p);
-		}
-		catch(rt::permission_error & e)
+	//list scheduling: the ready job with the longest path first, on the cpu where it can start first
+	std::vector<unsigned int> cpu_free(cpu_ids.size(), 0), start(n, 0), finish(n, 0), cpu(n, 0);
+	std::vector<bool> scheduled(n, false);
+	unsigned int makespan = 0;
+	for (size_t k = 0; k < n; k++)
+	{
+		size_t best = n;
+		for (size_t i = 0; i < n; i++)
 		{
-			std::cerr << "Error setting priorities" << e.what()<<  std::endl;
-			th.detach();
-			return;
+			bool ready = !scheduled[i];
+			for (uint64_t p = preds[i]; ready && p != 0; p &= p - 1)
+				ready = scheduled[pos[__builtin_ctzll(p)]];
+
+			if (ready && (best == n || level[i] > level[best]))
+				best = i;
 		}
-}
 
-void Executive::task_function(Executive::task_data & task,  std::mutex &state_mutex)
-{
-	while (true)
-	{
-		{
-			std::unique_lock<std::mutex> lock(state_mutex);
-			while (task.state!= PENDING)
-			{
-				task.cond.wait(lock);
-			}
-			task.state=RUNNING;
-			
-			//debug
-			if (task.type == PERIODIC)
-			{
-				std::ostringstream debug;
-				debug << "Task " << task.id << " RUNNING"<< std::endl;
-				std::cout << debug.str();
-			}
-			else
-			{
-				std::ostringstream debug;
-				debug << "Task Aperiodico RUNNING"<< std::endl;
-				std::cout << debug.str();
-			}
-			
-		} 
+		unsigned int earliest = 0;
+		for (uint64_t p = preds[best]; p != 0; p &= p - 1)
+			earliest = std::max(earliest, finish[pos[__builtin_ctzll(p)]]);
 
-		task.function();
+		size_t c = 0;
+		for (size_t d = 1; d < cpu_ids.size(); d++)
+			if (std::max(cpu_free[d], earliest) < std::max(cpu_free[c], earliest))
+				c = d;
 
-		{
-			std::unique_lock<std::mutex> lock(state_mutex);
-			task.state = IDLE;
-			
-			//debug
-			if (task.type == PERIODIC)
-			{
-				std::ostringstream debug;
-				debug << "Task " << task.id << " IDLE"<< std::endl;
-				std::cout << debug.str();
-			}
-			else
-			{
-				std::ostringstream debug;
-				debug << "Task Aperiodico IDLE"<< std::endl;
-				std::cout << debug.str();
-			}
-		}
+		start[best] = std::max(cpu_free[c], earliest);
+		finish[best] = cpu_free[c] = start[best] + wcet[best];
+		cpu[best] = cpu_ids[c];
+		scheduled[best] = true;
+		makespan = std::max(makespan, finish[best]);
+	}
 
+	assert(makespan <= frame_length); //It fails if the frame is overloaded
+
+	//dispatch order (and priority) by start time: a topological order, as the fallback releases the jobs in order
+	std::vector<size_t> order(n);
+	for (size_t i = 0; i < n; i++)
+		order[i] = i;
+	std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return start[a] < start[b] || (start[a] == start[b] && level[a] > level[b]); });
+
+	std::vector<size_t> ids(n);
+	frame_dag dag;
+	for (size_t i = 0; i < n; i++)
+	{
+		ids[i] = frame[order[i]];
+		dag.preds.push_back(preds[order[i]]);
+		dag.succs.push_back(succs[order[i]]);
+		dag.cpu.push_back(cpu[order[i]]);
+		if (!p_tasks[ids[i]].slice_wcets.empty())
+			p_tasks[ids[i]].release_frames.push_back(frames.size());
+		++p_tasks[ids[i]].releases;
 	}
+
+	frames.push_back(ids, frame_length - makespan);
+	dags.push_back(dag);
 }
 
-//EXECUTIVE THREAD
-void Executive::exec_function()
+bool Executive::build_schedule()
 {
-	unsigned long frame_id = 0;
-
-	auto last = std::chrono::steady_clock::now();
-	auto next_frame = std::chrono::steady_clock::now();	
+	assert(frames.empty()); //It fails if the frames are already defined
 
-	bool ap_running = false;
+	struct job
+	{
+		size_t task_id;
+		unsigned int deadline;
+		unsigned int remaining; //remaining wcet
+		size_t slice; //next slice (sliced tasks)
+		bool started;
+	};
 
-	while (true)
+	unsigned int hyperperiod = 1;
+	for (auto & task: p_tasks)
 	{
-		std::ostringstream debug;
-		debug << "-----Executive: frame_id " << frame_id <<  " starting-----" << std::endl;			
-		std::cout << debug.str();
+		assert(task.period > 0); //It fails if a task has no period
 		
-
-		//ap_request check
+		unsigned int a = hyperperiod, b = task.period;
+		while (b != 0)
 		{
-			std::unique_lock<std::mutex> lock(ap_request_mutex);
-			if(ap_request)
-			{
-				if(ap_running)
-				{
-					std::cout << "Deadline miss task aperiodico"<< std::endl;
-				}
-				else
-				{
-					ap_running = true;
-				}
-				ap_request = false;
-			}
+			unsigned int r = a % b;
+			a = b;
+			b = r;
 		}
+		hyperperiod = hyperperiod / a * task.period;
+	}
 
+	if (hyperperiod % frame_length != 0)
+	{
+		if (verbose)
+			std::cerr << "build_schedule: the frame length does not divide the hyperperiod " << hyperperiod << std::endl;
+		return false;
+	}
 
+	std::vector< std::vector<size_t> > schedule(hyperperiod / frame_length);
+	std::vector< std::vector<unsigned int> > budgets(p_tasks.size());
+	std::vector< std::vector<bool> > firsts(p_tasks.size());
+	std::vector<job> jobs;
+	std::vector<unsigned int> next_release(p_tasks.size(), 0);
 
-		//SET PRIORITY & WAKE-UP TASK
-		//Tasks' priority is set dinamiccaly in each frame.
-		/**
-		 * PRIORITY MANAGMENT
-		 * 
-		 * Executive has always the maximum priority.
-		 * If in ap_running the policy used is 'slack stealing': during the slack time any periodic task in deadline miss has
-		 * priority equal to (MAX - 1), the aperiodic task has priority (MAX - 2), while the periodic tasks to schedule in the frame
-		 * have lower priority.
-		 * At the end of slack time, when the executive wakes up, the aperiodic task's priority is set to MIN,
-		 * the one of any periodic task in deadline miss to (MIN + 1), while the one of the other periodic task will be higher
-		 * and defined according to the established order execution.
-		 * 
-		 * In particular: if a task is in deadline miss and it has an execution even in the next fram, then its execution is skipped.
-		 * The task in question executes in any remaining time at the end of the frame (and / or in the slack time) in order to avoid
-		 * delaying periodic tasks.
-		 * 
-		 */
-		rt::priority thread_prio(rt::priority::rt_max);
-		thread_prio -= 3;
-		rt::affinity aff("1");
+	for (size_t f = 0; f < schedule.size(); ++f)
+	{
+		unsigned int start = f * frame_length;
+		unsigned int end = start + frame_length;
+
+		//jobs released up to the frame start are ready
+		for (size_t id = 0; id < p_tasks.size(); ++id)
 		{
-			std::unique_lock<std::mutex> lock(state_mutex);
-			for (size_t i = 0; i < frames[frame_id].size(); i++)
+			while (next_release[id] <= start)
 			{
-				if (p_tasks[frames[frame_id][i]].state == IDLE)
-				{
-					set_thread_priority(p_tasks[frames[frame_id][i]].thread, thread_prio);
-					rt::set_affinity(p_tasks[frames[frame_id][i]].thread, aff);
-					--thread_prio;
-
-					p_tasks[frames[frame_id][i]].state = PENDING;
-					
-					std::ostringstream debug;
-					debug << "Task " << p_tasks[frames[frame_id][i]].id << " PENDING"<< std::endl;
-					std::cout<< debug.str();
-					
-					p_tasks[frames[frame_id][i]].cond.notify_one();
-				}
+				job j = {id, next_release[id] + p_tasks[id].period, p_tasks[id].wcet, 0, false};
+				jobs.push_back(j);
+				next_release[id] += p_tasks[id].period;
 			}
 		}
 
-		//WAKE-UP APERIODIC
-		if (ap_running)
-		{
-			rt::priority prio(rt::priority::rt_max);
-			--prio;
+		//earliest deadline first (ties by task id)
+		std::stable_sort(jobs.begin(), jobs.end(), [](const job & a, const job & b) { return a.deadline < b.deadline; });
 
-			for(size_t i = 0; i < p_tasks.size(); i++)
+		unsigned int capacity = frame_length;
+		for (auto & j: jobs)
+		{
+			if (j.deadline < end)
 			{
-				if(p_tasks[i].miss)
-				{
-					set_thread_priority(p_tasks[i].thread, prio);
-				}
+				if (verbose)
+					std::cerr << "build_schedule: task " << j.task_id << " misses the deadline " << j.deadline << std::endl;
+				return false;
 			}
 
-			--prio;
-			set_thread_priority(ap_task.thread, prio);
-
-			{
-				std::unique_lock<std::mutex> lock(state_mutex);
-				if (ap_task.state == IDLE)
-				{
-					ap_task.state = PENDING;
-					
-					std::ostringstream debug;
-					debug << "Task Aperiodico PENDING"<< std::endl;
-					std::cout<< debug.str();
-					
-					ap_task.cond.notify_one();
-				}
-			}
+			const task_data & task = p_tasks[j.task_id];
+			unsigned int w = 0;
 
-			std::ostringstream debug;
-			debug << "-----Exec Sleeping for SLACK TIME-----" << std::endl;
-			std::cout << debug.str();
+			if (!task.slices.empty())
+				w = task.slice_wcets[j.slice];
+			else if (task.resumable)
+				w = std::min(j.remaining, capacity);
+			else
+				w = j.remaining;
 
-			//Executive sleeps for slack_time
-			next_frame += std::chrono::milliseconds(slack_times[frame_id]*unit_time);
-			std::this_thread::sleep_until(next_frame);
-			
-			auto next = std::chrono::steady_clock::now();
-				
-			std::chrono::duration<double, std::milli> elapsed(next - last);
+			if (w == 0 || w > capacity)
+				continue;
 
-			std::ostringstream debug1;
-			debug1 << "-----Exec: end slack time" << elapsed.count() << "-----"<< std::endl;
-			std::cout << debug1.str();
+			schedule[f].push_back(j.task_id);
+			capacity -= w;
+			j.remaining -= w;
+			++j.slice;
 
-			//Executive wakes up and updates priority to the aperiodic task and to any periodic task in deadline miss.
-			set_thread_priority(ap_task.thread, prio);
-			
-			++prio;
-			for(size_t i = 0; i < p_tasks.size(); i++)
+			if (task.resumable)
 			{
-				if(p_tasks[i].miss)
-				{
-					set_thread_priority(p_tasks[i].thread, prio);
-				}
+				budgets[j.task_id].push_back(w);
+				firsts[j.task_id].push_back(!j.started);
 			}
-
-			next_frame += std::chrono::milliseconds((frame_length*unit_time)-slack_times[frame_id]*unit_time);
-		}
-		else
-		{
-			std::ostringstream debug;
-			debug << "-----Exec sleeping for FRAME TIME-----" << std::endl;
-			std::cout << debug.str();
-			
-			next_frame += std::chrono::milliseconds(frame_length*unit_time);
+			j.started = true;
 		}
 
-		std::this_thread::sleep_until(next_frame);
-		auto next = std::chrono::steady_clock::now();
-		std::chrono::duration<double, std::milli> elapsed(next - last);
-		
-		std::ostringstream debug2;
-		debug2 << "------Exec: end frame " << elapsed.count() << "-----"<< std::endl << std::endl << std::endl;
-		std::cout << debug2.str();
-		last = next;
-		
-		//CHECK DEADLINE MISS
-		rt::priority miss_prio(rt::priority::rt_min);
-		++miss_prio;
-		
-		{
-			std::unique_lock<std::mutex> lock(state_mutex);
-			for(size_t i = 0; i < p_tasks.size(); i++)
-			{
-				if((p_tasks[i].miss) && (p_tasks[i].state == IDLE))
-				{
-					p_tasks[i].miss = false;
-				}
-			}
-
-			if(ap_task.state == IDLE && ap_running)
-			{
-				ap_running = false;
-			}
-
-			for (size_t i = 0; i < frames[frame_id].size(); i++)
-			{				
-				std::ostringstream debug;
-
-				if (p_tasks[frames[frame_id][i]].state != IDLE)
-				{
-					p_tasks[frames[frame_id][i]].miss = true;
-					set_thread_priority(p_tasks[frames[frame_id][i]].thread, miss_prio);
-					
-					debug << "Deadline miss task periodico di ID "<< p_tasks[frames[frame_id][i]].id << std::endl;
-					std::cout << debug.str();
-				}
-				else
-				{
-					debug << "Check miss superato. Task periodico: stato IDLE, ID " << p_tasks[frames[frame_id][i]].id << std::endl;
-					std::cout << debug.str();
-				}
-				
-			}
-		}
+		jobs.erase(std::remove_if(jobs.begin(), jobs.end(), [](const job & j) { return j.remaining == 0; }), jobs.end());
+	}
 
-		std::ostringstream debug3;
-		debug3 << std::endl << std::endl;
-		std::cout << debug3.str();
-		
+	if (!jobs.empty())
+	{
+		if (verbose)
+			std::cerr << "build_schedule: task " << jobs.front().task_id << " cannot complete in the hyperperiod" << std::endl;
+		return false;
+	}
 
-		//FRAME ADVANCE
-		if (++frame_id == frames.size())
+	for (size_t id = 0; id < p_tasks.size(); ++id)
+	{
+		if (p_tasks[id].resumable)
 		{
-			frame_id = 0;
+			p_tasks[id].slice_wcets = budgets[id];
+			p_tasks[id].slice_first = firsts[id];
 		}
 	}
+
+	for (auto & frame: schedule)
+		add_frame(frame);
+
+	return true;
 }
 
+void Executive::set_shm_stats(const std::string & name)
+{
+	shm_name = name;
+}
+
+void Executive::set_profiling(unsigned int hyperperiods, double margin)
+{
+	assert(hyperperiods > 0); //It fails if the profiling run is empty
 
+	profile_hyperperiods = hyperperiods;
+	profile_margin = margin;
+}
+
+void Executive::set_clock_source(frame_clock & source)
+{
+	clock = &source;
+}
+
+void Executive::set_overrun_policy(overrun_policy policy, unsigned int tolerance)
+{
+	assert(tolerance > 0); //It fails if every start would be late
+
+	late_policy = policy;
+	late_tolerance = tolerance;
+}
+
+void Executive::set_trace_record(const std::string & path, size_t capacity)
+{
+	trace_path = path;
+	trace_capacity = capacity;
+}
+
+bool Executive::set_trace_replay(const std::string & path, bool synthetic)
+{
+	replaying = false;
+	if (!trace_in.load(path))
+		return false;
+
+	if (trace_in.num_tasks() != p_tasks.size() || trace_in.frame() != std::chrono::nanoseconds(frame_length * unit_time))
+	{
+		std::cerr << path << ": recorded with " << trace_in.num_tasks() << " tasks and frames of " << trace_in.frame().count()
+			<< " ns, not with this executive" << std::endl;
+		return false;
+	}
+
+	replaying = true;
+	replay_synthetic = synthetic;
+	return true;
+}
+
+void Executive::set_ap_server(ap_policy policy, unsigned int budget, unsigned int period)
+{
+	assert(period > 0); //It fails if the budget is never replenished
+	assert(budget > 0 || policy == SLACK_STEALING || policy == BACKGROUND); //It fails if the server has no budget
+
+	ap_server = policy;
+	server_budget = budget;
+	server_period = period;
+}
+
+void Executive::set_affinity(const rt::affinity & cpus)
+{
+	assert(cpus.any()); //It fails if no cpu is given
+
+	this->cpus = cpus;
+}
+
+void Executive::set_max_priority(rt::priority prio)
+{
+	assert(prio.is_rt() && prio - rt::priority::rt_min >= 3); //It fails if the task and aperiodic priorities do not fit below it
+
+	max_prio = prio;
+}
+
+void Executive::set_ap_ring(const std::string & name, unsigned int capacity, bool doorbell, mode_t mode)
+{
+	assert(capacity > 0); //It fails if the ring has no slots
+
+	ring_name = name;
+	ring_capacity = capacity;
+	ring_doorbell = doorbell;
+	ring_mode = mode;
+}
+
+void Executive::set_let_output(size_t task_id, let_output_port & output)
+{
+	assert(task_id < p_tasks.size()); //It fails if task_id is not correct (out of range)
+
+	p_tasks[task_id].let_outputs.push_back(&output);
+}
+
+void Executive::set_let_input(size_t task_id, let_input_port & input)
+{
+	assert(task_id < p_tasks.size()); //It fails if task_id is not correct (out of range)
+
+	p_tasks[task_id].let_inputs.push_back(&input);
+}
+
+void Executive::set_fault_injector(fault_injector & injector)
+{
+	faults = &injector;
+}
+
+void Executive::set_ap_pool(ap_pool & pool)
+{
+	this->pool = &pool;
+}
+
+void Executive::set_accounting(bool enable)
+{
+	accounting = enable;
+}
+
+Executive::job_accounting Executive::get_accounting(size_t task_id) const
+{
+	assert(task_id < slots.size()); //It fails if task_id is not correct (out of range)
+
+	return task_id < p_tasks.size() ? p_tasks[task_id].accounting : ap_task.accounting;
+}
+
+void Executive::set_perf_counters(bool enable)
+{
+	perf = enable;
+}
+
+Executive::job_counters Executive::get_counters(size_t task_id) const
+{
+	assert(task_id < slots.size()); //It fails if task_id is not correct (out of range)
+
+	return task_id < p_tasks.size() ? p_tasks[task_id].counters : ap_task.counters;
+}
+
+void Executive::set_job_arena(size_t task_id, size_t bytes)
+{
+	assert(task_id < slots.size()); //It fails if task_id is not correct (out of range)
+
+	task_data & task = task_id < p_tasks.size() ? p_tasks[task_id] : ap_task;
+	task.arena = std::make_unique<job_arena>(bytes);
+}
+
+const job_arena * Executive::get_job_arena(size_t task_id) const
+{
+	assert(task_id < slots.size()); //It fails if task_id is not correct (out of range)
+
+	const task_data & task = task_id < p_tasks.size() ? p_tasks[task_id] : ap_task;
+	return task.arena.get();
+}
+
+void Executive::set_unprivileged(bool force)
+{
+	force_unprivileged = force;
+}
+
+void Executive::set_verbose(bool enable)
+{
+	verbose = enable;
+}
+
+size_t Executive::num_frames() const
+{
+	return frames.size();
+}
+
+unsigned int Executive::slack_time(size_t frame_id) const
+{
+	assert(frame_id < frames.size()); //It fails if frame_id is not correct (out of range)
+	
+	return frames.slack(frame_id);
+}
+
+size_t Executive::schedule_memory() const
+{
+	return frames.memory();
+}
+
+Executive::exec_stats Executive::get_stats() const
+{
+	return stats;
+}
+
+void Executive::set_deadline_server(unsigned int ap_budget, unsigned int recovery_budget)
+{
+	assert(ap_budget > 0); //It fails if the aperiodic server has no budget
+
+	deadline_server = true;
+	this->ap_budget = ap_budget;
+	this->recovery_budget = recovery_budget;
+}
+
+//START RUN
+void Executive::run(unsigned int hyperperiods)
+{
+	//the frames with the same tasks share their ids in the table
+	frames.compress();
+
+	max_frames = hyperperiods * frames.size();
+	stop = false;
+	hi_mode = false;
+
+	for (auto & slot: slots)
+	{
+		slot.window_cut = false;
+		slot.release_frame = slot.done_frame = ULONG_MAX;
+		slot.preds = slot.succs = 0;
+	}
+	perf_error.clear();
+	server_left = std::chrono::nanoseconds::zero();
+
+	//the scripted job faults are injected only in the frames where their task is released
+	if (faults != nullptr)
+		for (auto & f: faults->scripted())
+		{
+			if (f.type == fault_injector::BURST)
+				continue;
+
+			frame_table::frame_view fv = frames[f.frame % frames.size()];
+			if (std::find(fv.begin(), fv.end(), f.task_id) == fv.end())
+				std::cerr << "Fault at frame " << f.frame << " not injected: task " << f.task_id << " is not released in frame_id "
+					<< f.frame % frames.size() << std::endl;
+		}
+
+	bool arenas = false;
+	for (size_t id = 0; id < slots.size(); ++id)
+	{
+		task_data & task = id < p_tasks.size() ? p_tasks[id] : ap_task;
+		task.accounting = job_accounting();
+		task.counters = job_counters();
+		if (task.arena)
+		{
+			task.arena->reset_stats();
+			arenas = true;
+		}
+	}
+	ap_backlog_head = 0;
+	ap_backlog_size = 0;
+
+	degraded = force_unprivileged || !rt_permitted();
+	stats.degraded = degraded;
+	if (degraded)
+	{
+		std::cerr << "Real-time priorities not available: unprivileged fallback, jobs run to completion (degraded measurements)" << std::endl;
+		if (deadline_server)
+		{
+			std::cerr << "Deadline server not available in the unprivileged fallback" << std::endl;
+			deadline_server = false;
+		}
+	}
+
+	if (profile_hyperperiods > 0)
+	{
+		max_frames = profile_hyperperiods * frames.size();
+
+		//one sample per release of the task in the profiled frames (at most one aperiodic job per frame)
+		for (size_t f = 0; f < frames.size(); ++f)
+			for (auto & id: frames[f])
+				p_tasks[id].samples.resize(p_tasks[id].samples.size() + profile_hyperperiods);
+		ap_task.samples.resize(max_frames);
+	}
+
+	ap_responses.clear();
+	ap_responses.reserve(max_frames);
+
+	//the ring of the records is preallocated: for a finite run, one per job and two requests per frame
+	if (!trace_path.empty())
+	{
+		size_t jobs = 0;
+		for (size_t f = 0; f < frames.size(); ++f)
+			jobs += frames[f].size();
+
+		size_t capacity = trace_capacity;
+		if (capacity == 0)
+			capacity = max_frames > 0 ? (jobs + 2 * frames.size()) * (max_frames / frames.size()) : TRACE_RECORDS;
+		trace_out.reset(p_tasks.size(), frame_length * unit_time, capacity);
+	}
+
+	if (!shm_name.empty())
+	{
+		shm = shm_stats_create(shm_name.c_str(), p_tasks.size(), frame_length, unit_time.count() * 1000);
+		if (shm == nullptr)
+			std::cerr << "Error creating the shared-memory statistics " << shm_name << std::endl;
+	}
+
+	if (!ring_name.empty())
+	{
+		if (ring_doorbell)
+		{
+			doorbell_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+			if (doorbell_fd < 0)
+				std::cerr << "Error creating the doorbell of " << ring_name << std::endl;
+		}
+
+		ring = ap_ring_create(ring_name.c_str(), ring_capacity, doorbell_fd, ring_mode);
+		if (ring == nullptr)
+			std::cerr << "Error creating the aperiodic request ring " << ring_name << std::endl;
+	}
+
+	//EXECUTIVE THREAD INITIALIZATION
+	//default rt_max, not read at the construction (the executive may be a static object)
+	if (!max_prio.is_rt())
+		max_prio = rt::priority::rt_max;
+	rt::priority exec_prio(max_prio);
+	rt::affinity aff(cpus);
+
+
+	//PERIODIC TASK THREAD INITIALIZATION
+	for (size_t id = 0; id < p_tasks.size(); ++id)
+	{
+		
+		assert(p_tasks[id].function || !p_tasks[id].slices.empty() || p_tasks[id].resumable); //It fails if set_periodic_task() has not been invoked for this id
+		
+		p_tasks[id].thread = std::thread(&Executive::task_function, this, std::ref(p_tasks[id]));
+
+	}
+	
+
+	//APERIODIC TASK THREAD INITIALIZATION
+	assert(ap_task.function || ap_body); // It fails if set_aperiodic_task() has not been invoked
+
+	for (auto & task: p_tasks)
+	{
+		assert(task.slice_wcets.empty() || task.releases % task.slice_wcets.size() == 0); //It fails if the releases of a sliced task in the hyperperiod are not whole jobs
+		assert(task.slice_wcets.empty() || task.let_inputs.empty()); //It fails if a sliced or resumable task reads a LET input
+	}
+	
+	if (ap_body)
+	{
+		assert(!deadline_server); //It fails if the coroutine aperiodic task is used with the deadline server
+
+		//the aperiodic coroutine is resumed by the executive thread: no aperiodic thread
+	}
+	else if (deadline_server)
+	{
+		//The server budget must not steal time to the periodic tasks of any frame: the reservations are not aligned to
+		//the frames, so a frame can see the end of the budget of a period and the start of the next one
+		unsigned int min_slack = frame_length;
+		for (size_t f = 0; f < frames.size(); ++f)
+			min_slack = std::min(min_slack, frames.slack(f));
+		assert(2 * (ap_budget + recovery_budget) <= min_slack); //It fails if twice the budgets exceed a slack time
+
+		max_recoveries = recovery_budget > 0 ? (min_slack - 2 * ap_budget) / (2 * recovery_budget) : 0;
+
+		//The aperiodic thread installs its own reservation (it is not pinned: see rt/deadline.h)
+		ap_task.dl_budget = ap_budget * unit_time;
+		ap_task.dl_period = frame_length * unit_time;
+		ap_task.thread = std::thread(&Executive::task_function, this, std::ref(ap_task));
+	}
+	else
+	{
+		ap_task.thread = std::thread(&Executive::task_function, this, std::ref(ap_task));
+		rt::priority a_prio(rt::priority::rt_min);
+
+		set_thread_priority(ap_task.thread, a_prio);
+		rt::set_affinity(ap_task.thread, aff);
+	}
+	
+	//APERIODIC POOL INITIALIZATION
+	if (pool != nullptr)
+	{
+		assert(!ap_body); //It fails if the aperiodic pool is used with the coroutine aperiodic task
+
+		if ((pool->cpus() & cpus).any())
+			std::cerr << "The aperiodic pool shares cpus with the executive: its workers only run in the idle time of the periodic schedule" << std::endl;
+
+		//the workers record the response times and publish the completions; a request of the ring has a deadline in frames
+		pool->set_completion([this](const ap_pool_job & job)
+		{
+			auto done = std::chrono::steady_clock::now();
+
+			std::unique_lock<rt::pi_mutex> lock(state_mutex);
+			ap_completed(job.arrival, done);
+			if (job.request.deadline > 0 && done - job.arrival > job.request.deadline * frame_length * unit_time)
+				++stats.ap_misses;
+
+			//the jobs of the pool end out of order: each request has its completion slot
+			if (job.from_ring)
+				ring->complete(job.request.id);
+		});
+		pool->start();
+	}
+
+	std::thread exec_thread(&Executive::exec_function, this);
+
+	set_thread_priority(exec_thread, exec_prio);
+	rt::set_affinity(exec_thread, aff);
+	
+	
+	//FINAL JOIN
+	exec_thread.join();
+
+	if (pool != nullptr)
+		pool->stop();
+	
+	if (ap_task.thread.joinable())
+		ap_task.thread.join();
+	
+	for (auto & pt: p_tasks)
+		pt.thread.join();
+
+	if (profile_hyperperiods > 0)
+		print_profile();
+
+	if (faults != nullptr)
+		print_fault_stats();
+
+	if (pool != nullptr)
+		print_pool_stats();
+
+	if (accounting)
+		print_accounting();
+
+	if (!trace_path.empty() && trace_out.save(trace_path))
+	{
+		std::cout << "Trace of " << trace_out.size() << " records written to " << trace_path;
+		if (trace_out.overwritten() > 0)
+			std::cout << " (" << trace_out.overwritten() << " older records overwritten: trace ring full)";
+		std::cout << std::endl;
+	}
+
+	if (perf)
+		print_counters();
+
+	if (arenas)
+		print_arenas();
+
+	if (shm != nullptr)
+	{
+		shm_stats_close(shm);
+		shm_unlink(shm_name.c_str());
+		shm = nullptr;
+	}
+
+	if (ring != nullptr)
+	{
+		ap_ring_close(ring);
+		shm_unlink(ring_name.c_str());
+		ring = nullptr;
+	}
+
+	if (doorbell_fd >= 0)
+	{
+		close(doorbell_fd);
+		doorbell_fd = -1;
+	}
+}
+
+void Executive::ap_task_request() 
+{
+	ap_task_request(ap_request_data());
+}
+
+void Executive::ap_task_request(const ap_request_data & request)
+{
+	std::unique_lock<rt::pi_mutex> lock(ap_request_mutex);
+	ap_request = true;
+	ap_local_request = request;
+	ap_local_request.sent_ns = 0;
+	ap_request_time = std::chrono::steady_clock::now();
+}
+
+const ap_request_data & Executive::ap_current_request() const
+{
+	//the jobs of the pool run concurrently: each one reads its own request
+	const ap_pool_job * job = ap_pool::current_job();
+	return job != nullptr ? job->request : ap_current;
+}
+
+const std::vector<std::chrono::nanoseconds> & Executive::ap_response_times() const
+{
+	return ap_responses;
+}
+
+bool Executive::rt_permitted()
+{
+	//the probe changes the priority of a thread of its own, not of the caller
+	bool permitted = true;
+	std::thread probe([&permitted]()
+	{
+		try
+		{
+			rt::this_thread::set_priority(rt::priority(rt::priority::rt_min));
+		}
+		catch(rt::permission_error & e)
+		{
+			permitted = false;
+		}
+	});
+	probe.join();
+
+	return permitted;
+}
+
+void Executive::set_thread_priority(std::thread &th, rt::priority &p)
+{
+	//unprivileged fallback: the order of the jobs is kept by the executive
+	if (degraded)
+		return;
+
+	try
+		{
+			rt::set_priority(th,p);
+		}
+		catch(rt::permission_error & e)
+		{
+			//the thread stays joinable: run() still waits for it
+			std::cerr << "Error setting priorities" << e.what()<<  std::endl;
+			return;
+		}
+}
+
+unsigned int Executive::demote()
+{
+	std::unique_lock<rt::pi_mutex> lock(state_mutex);
+	if (stop)
+		return 0; //run() is ending: the threads are being joined
+
+	unsigned int cut = 0;
+	rt::priority background(rt::priority::not_rt);
+
+	for (size_t i = 0; i < slots.size(); ++i)
+	{
+		task_data & task = i < p_tasks.size() ? p_tasks[i] : ap_task;
+		std::thread & th = task.thread;
+		if (slots[i].state == IDLE || !th.joinable())
+			continue;
+
+		task.window_prio = rt::get_priority(th);
+		set_thread_priority(th, background);
+
+		//the aperiodic job has no deadline at the window end
+		if (i < p_tasks.size())
+		{
+			slots[i].window_cut = true;
+			++cut;
+		}
+	}
+
+	return cut;
+}
+
+void Executive::restore()
+{
+	std::unique_lock<rt::pi_mutex> lock(state_mutex);
+	if (stop)
+		return;
+
+	for (size_t i = 0; i < slots.size(); ++i)
+	{
+		task_data & task = i < p_tasks.size() ? p_tasks[i] : ap_task;
+		std::thread & th = task.thread;
+		if (task.window_prio == rt::priority::not_rt || !th.joinable())
+			continue;
+
+		//the executive then lowers the periodic ones to the miss priority
+		if (slots[i].state != IDLE)
+			set_thread_priority(th, task.window_prio);
+
+		task.window_prio = rt::priority::not_rt;
+	}
+}
+
+void Executive::print_blocking_stats()
+{
+	rt::mutex_stats state_stats, request_stats;
+	{
+		std::unique_lock<rt::pi_mutex> lock(state_mutex);
+		state_stats = state_mutex.stats();
+	}
+	{
+		std::unique_lock<rt::pi_mutex> lock(ap_request_mutex);
+		request_stats = ap_request_mutex.stats();
+	}
+
+	if (!verbose)
+		return;
+
+	std::ostringstream debug;
+	debug << "-----Exec: blocking time (hyperperiod end)-----" << std::endl
+		<< "state_mutex: " << state_stats.contentions << "/" << state_stats.acquisitions << " contended, max "
+		<< std::chrono::duration<double, std::micro>(state_stats.max_blocking).count() << "us, total "
+		<< std::chrono::duration<double, std::micro>(state_stats.total_blocking).count() << "us" << std::endl
+		<< "ap_request_mutex: " << request_stats.contentions << "/" << request_stats.acquisitions << " contended, max "
+		<< std::chrono::duration<double, std::micro>(request_stats.max_blocking).count() << "us" << std::endl << std::endl;
+	std::cout << debug.str();
+}
+
+void Executive::account_job(task_data & task, const job_usage & usage, std::chrono::nanoseconds budget)
+{
+	job_accounting & a = task.accounting;
+	std::chrono::nanoseconds cpu = usage.user + usage.kernel;
+
+	++a.jobs;
+	a.total_wall += usage.wall;
+	a.total_cpu += cpu;
+	a.max_cpu = std::max(a.max_cpu, cpu);
+	a.total_kernel += usage.kernel;
+	a.total_wait += usage.wait;
+	a.max_wait = std::max(a.max_wait, usage.wait);
+	a.voluntary += usage.voluntary;
+	a.involuntary += usage.involuntary;
+
+	std::chrono::nanoseconds response(std::chrono::steady_clock::now() - task.slot->release);
+	a.min_response = a.jobs == 1 ? response : std::min(a.min_response, response);
+	a.max_response = std::max(a.max_response, response);
+
+	if (task.type == PERIODIC && task.slot->miss)
+	{
+		//the rest of the response time is spent blocked or sleeping (or lost to the accounting granularity)
+		std::chrono::nanoseconds blocked = usage.wall - cpu - usage.wait;
+
+		//otherwise the largest part of the response time: before the start (the frame's earlier jobs), in the run queue, or blocked
+		if (cpu > budget)
+			++a.self_overruns;
+		else if (usage.delay >= usage.wait && usage.delay >= blocked)
+			++a.delayed_misses;
+		else if (usage.wait > blocked)
+			++a.preempted_misses;
+		else
+			++a.blocked_misses;
+	}
+}
+
+void Executive::print_accounting()
+{
+	std::ostringstream report;
+	report << "-----JOB ACCOUNTING (mean per job, ms)-----" << std::endl;
+	report << std::fixed;
+	report.precision(3);
+	report << "task	jobs	wall	cpu	cpu max	kernel	wait	wait max	vol cs	invol cs	misses: self-overrun	delayed	preempted	blocked" << std::endl;
+
+	auto ms = [](std::chrono::nanoseconds t, unsigned long jobs) { return std::chrono::duration<double, std::milli>(t).count() / std::max(jobs, 1UL); };
+
+	for (size_t i = 0; i < slots.size(); ++i)
+	{
+		const job_accounting & a = i < p_tasks.size() ? p_tasks[i].accounting : ap_task.accounting;
+
+		if (i < p_tasks.size())
+			report << i;
+		else
+			report << "ap";
+
+		report << "\t" << a.jobs << "\t" << ms(a.total_wall, a.jobs) << "\t" << ms(a.total_cpu, a.jobs) << "\t" << ms(a.max_cpu, 1)
+			<< "\t" << ms(a.total_kernel, a.jobs) << "\t" << ms(a.total_wait, a.jobs) << "\t" << ms(a.max_wait, 1)
+			<< "\t" << (double) a.voluntary / std::max(a.jobs, 1UL) << "\t" << (double) a.involuntary / std::max(a.jobs, 1UL)
+			<< "\t" << a.self_overruns << "\t\t\t" << a.delayed_misses << "\t" << a.preempted_misses << "\t\t" << a.blocked_misses << std::endl;
+	}
+
+	std::cout << report.str();
+}
+
+void Executive::print_counters()
+{
+	std::ostringstream report;
+	report << "-----HARDWARE COUNTERS (mean per job)-----" << std::endl;
+
+	if (!perf_error.empty())
+	{
+		report << "counters not available (" << perf_error << ")" << std::endl;
+		std::cout << report.str();
+		return;
+	}
+
+	report << std::fixed;
+	report.precision(0);
+	report << "task\tjobs";
+	for (int e = 0; e < rt::perf_counters::NUM_EVENTS; ++e)
+		report << "\t" << rt::perf_counters::name(rt::perf_counters::event(e));
+	report << "\tipc\tllc-misses max" << std::endl;
+
+	for (size_t i = 0; i < slots.size(); ++i)
+	{
+		const job_counters & c = i < p_tasks.size() ? p_tasks[i].counters : ap_task.counters;
+		if (c.jobs == 0)
+			continue;
+
+		if (i < p_tasks.size())
+			report << i;
+		else
+			report << "ap";
+
+		report << "\t" << c.jobs;
+		for (int e = 0; e < rt::perf_counters::NUM_EVENTS; ++e)
+			report << "\t" << (double) c.total[e] / c.jobs;
+
+		double cycles = c.total[rt::perf_counters::CYCLES];
+		report.precision(2);
+		report << "\t" << (cycles > 0 ? c.total[rt::perf_counters::INSTRUCTIONS] / cycles : 0);
+		report.precision(0);
+		report << "\t" << c.max[rt::perf_counters::LLC_MISSES] << std::endl;
+	}
+
+	std::cout << report.str();
+}
+
+void Executive::print_arenas()
+{
+	std::ostringstream report;
+	report << "-----JOB ARENAS (bytes)-----" << std::endl;
+	report << "task	capacity	high-water	failed allocations" << std::endl;
+
+	for (size_t i = 0; i < slots.size(); ++i)
+	{
+		const job_arena * arena = get_job_arena(i);
+		if (arena == nullptr)
+			continue;
+
+		if (i < p_tasks.size())
+			report << i;
+		else
+			report << "ap";
+
+		report << "	" << arena->capacity() << "		" << arena->high_water() << "		" << arena->failures();
+		if (!arena->locked())
+			report << " (not locked)";
+		report << std::endl;
+	}
+
+	std::cout << report.str();
+}
+
+void Executive::print_fault_stats()
+{
+	fault_injector::recovery_stats fs = faults->get_stats();
+
+	std::ostringstream report;
+	report << std::fixed;
+	report.precision(2);
+	report << "-----Fault injection: " << fs.injected << " faults, " << fs.episodes << " recovery episodes, "
+		<< fs.recovered << " recovered";
+	if (fs.recovered > 0)
+		report << ", recovery latency mean " << (double) fs.total_frames / fs.recovered << " max " << fs.max_frames << " frames";
+	if (fs.recovering)
+		report << " (last episode not recovered)";
+	if (fs.skipped > 0)
+		report << ", " << fs.skipped << " faults of skipped frames not injected";
+	report << "-----" << std::endl;
+
+	std::cout << report.str();
+}
+
+void Executive::print_pool_stats()
+{
+	ap_pool::pool_stats ps = pool->get_stats();
+
+	std::ostringstream report;
+	report << "-----Aperiodic pool: " << pool->workers() << " workers, " << ps.executed << " jobs, " << ps.stolen
+		<< " stolen, " << ps.rejected << " rejected; jobs per worker";
+	for (auto & n: ps.per_worker)
+		report << " " << n;
+	report << "-----" << std::endl;
+
+	std::cout << report.str();
+}
+
+void Executive::print_clock_stats()
+{
+	if (!verbose)
+		return;
+
+	frame_clock::clock_stats cs = clock->get_stats();
+	if (cs.frames == 0)
+		return;
+
+	std::ostringstream debug;
+	debug << "-----Exec: frame clock-----" << std::endl
+		<< "phase error: max " << std::chrono::duration<double, std::micro>(cs.max_phase_error).count() << "us, mean "
+		<< std::chrono::duration<double, std::micro>(cs.total_phase_error).count() / cs.frames << "us; jitter max "
+		<< std::chrono::duration<double, std::micro>(cs.max_jitter).count() << "us; drift " << cs.drift_ppm << "ppm";
+	if (cs.merged_ticks > 0)
+		debug << "; merged ticks " << cs.merged_ticks;
+	debug << std::endl << std::endl;
+	std::cout << debug.str();
+}
+
+void Executive::set_recovery_reservation(task_data &task)
+{
+	assert(!degraded); //It fails if the deadline server is used in the unprivileged fallback
+
+	//A deadline thread must span the whole root domain: the task is pinned again when it is next released
+	rt::affinity all;
+	all.set();
+	rt::set_affinity(task.thread, all);
+
+	try
+	{
+		rt::set_deadline_params(task.slot->tid, recovery_budget * unit_time, frame_length * unit_time, frame_length * unit_time);
+	}
+	catch(rt::permission_error & e)
+	{
+		std::cerr << "Error setting deadline parameters" << e.what() << std::endl;
+		rt::priority miss_prio(rt::priority::rt_min);
+		set_thread_priority(task.thread, ++miss_prio);
+	}
+}
+
+bool Executive::job_starts(const task_data & task) const
+{
+	if (!task.slices.empty())
+		return task.slot->next_slice == 0;
+	if (task.resumable)
+		return task.slice_first[task.slot->next_slice];
+	return true;
+}
+
+void Executive::release_slice(task_data & task, size_t frame_id)
+{
+	if (task.slice_wcets.empty())
+		return;
+
+	//the slice the frame was budgeted for, also after releases not made (miss, HI mode, skipped frames)
+	size_t k = std::lower_bound(task.release_frames.begin(), task.release_frames.end(), frame_id) - task.release_frames.begin();
+	size_t slice = k % task.slice_wcets.size();
+
+	//resumable task: a job whose first slice was not released starts at this one
+	if (task.resumable)
+		for (size_t s = task.slot->next_slice; s != slice; s = (s + 1) % task.slice_wcets.size())
+			if (task.slice_first[s])
+				task.slot->job_done = false;
+
+	task.slot->next_slice = slice;
+}
+
+bool Executive::preds_done(const task_data & task) const
+{
+	for (uint64_t p = task.slot->preds; p != 0; p &= p - 1)
+	{
+		const task_slot & pred = slots[__builtin_ctzll(p)];
+
+		//a predecessor not released in the frame (shed or still in miss) does not hold the job
+		if (pred.release_frame == task.slot->release_frame && pred.done_frame != task.slot->release_frame)
+			return false;
+	}
+	return true;
+}
+
+bool Executive::job_complete(const task_data & task) const
+{
+	if (!task.slices.empty())
+		return task.slot->next_slice == 0;
+	if (task.resumable)
+		return task.slot->job_done;
+	return true;
+}
+
+void Executive::run_job(task_data & task)
+{
+	//replay: the recorded cpu time of the job instead of its body
+	std::chrono::nanoseconds recorded;
+	if (replay_synthetic && trace_in.job_time(task.type == PERIODIC ? task.id : p_tasks.size(), task.slot->release_frame, recorded))
+	{
+		fault_injector::spin(recorded);
+
+		if (!task.slice_wcets.empty())
+		{
+			if (++task.slot->next_slice == task.slice_wcets.size())
+				task.slot->next_slice = 0;
+
+			//a resumable job completes with its last recorded slice
+			if (task.resumable)
+				task.slot->job_done = task.slice_first[task.slot->next_slice];
+		}
+		return;
+	}
+
+	if (!task.slices.empty())
+	{
+		task.slices[task.slot->next_slice]();
+		
+		if (++task.slot->next_slice == task.slices.size())
+			task.slot->next_slice = 0;
+	}
+	else if (task.resumable)
+	{
+		if (task.slice_first[task.slot->next_slice])
+			task.slot->job_done = false;
+
+		//the remaining slices of a job completed early are skipped; a slice cancelled at its deadline does not complete the job
+		if (!task.slot->job_done)
+			task.slot->job_done = task.resumable(task.slice_wcets[task.slot->next_slice]) && !task.slot->cancel.cancelled();
+
+		if (++task.slot->next_slice == task.slice_wcets.size())
+			task.slot->next_slice = 0;
+
+		if (!task.slot->job_done && task.slice_first[task.slot->next_slice] && verbose)
+		{
+			std::ostringstream debug;
+			debug << "Task " << task.id << " not complete at its last slice" << std::endl;
+			std::cout << debug.str();
+		}
+	}
+	else
+	{
+		task.function();
+	}
+}
+
+void Executive::task_function(task_data & task)
+{
+	{
+		std::unique_lock<rt::pi_mutex> lock(state_mutex);
+		task.slot->tid = rt::this_thread::get_tid();
+		pthread_getcpuclockid(pthread_self(), &task.slot->cpu_clock);
+	}
+
+	//accounting: the run-queue wait of the thread is read at each job from its schedstat
+	int schedstat = accounting ? open("/proc/thread-self/schedstat", O_RDONLY | O_CLOEXEC) : -1;
+
+	auto usage_now = [schedstat]()
+	{
+		job_usage u;
+		u.wall = std::chrono::steady_clock::now().time_since_epoch();
+
+		struct rusage ru;
+		getrusage(RUSAGE_THREAD, &ru);
+		u.user = std::chrono::seconds(ru.ru_utime.tv_sec) + std::chrono::microseconds(ru.ru_utime.tv_usec);
+		u.kernel = std::chrono::seconds(ru.ru_stime.tv_sec) + std::chrono::microseconds(ru.ru_stime.tv_usec);
+		u.voluntary = ru.ru_nvcsw;
+		u.involuntary = ru.ru_nivcsw;
+
+		//"<time on cpu> <time waiting in the run queue> <timeslices>", in nanoseconds
+		char buf[96] = {};
+		u.wait = std::chrono::nanoseconds::zero();
+		if (schedstat >= 0 && pread(schedstat, buf, sizeof(buf) - 1, 0) > 0)
+		{
+			char * next;
+			std::strtoull(buf, &next, 10);
+			u.wait = std::chrono::nanoseconds(std::strtoull(next, nullptr, 10));
+		}
+
+		return u;
+	};
+
+	//arena: reached by the job bodies through the thread
+	job_arena::set_current(task.arena.get());
+
+	//hardware counters: opened by the thread itself, they count its jobs only
+	std::unique_ptr<rt::perf_counters> counters;
+	if (perf)
+	{
+		counters = std::make_unique<rt::perf_counters>();
+		if (!counters->available())
+		{
+			std::unique_lock<rt::pi_mutex> lock(state_mutex);
+			if (perf_error.empty())
+				perf_error = counters->error();
+			counters.reset();
+		}
+	}
+	rt::perf_counters::sample job_start, job_end;
+
+	if (degraded && task.type == APERIODIC)
+	{
+		//unprivileged fallback: SCHED_IDLE (allowed without privileges) keeps the aperiodic job behind the periodic ones
+		struct sched_param param = {};
+		pthread_setschedparam(pthread_self(), SCHED_IDLE, &param);
+	}
+
+	if (task.dl_budget.count() > 0)
+	{
+		try
+		{
+			rt::this_thread::set_deadline_params(task.dl_budget, task.dl_period, task.dl_period);
+		}
+		catch(rt::permission_error & e)
+		{
+			std::cerr << "Error setting deadline parameters" << e.what() << std::endl;
+		}
+	}
+
+	while (true)
+	{
+		{
+			std::unique_lock<rt::pi_mutex> lock(state_mutex);
+			//precedence: the job also waits for its predecessors in the frame
+			while ((task.slot->state != PENDING || !preds_done(task)) && !stop)
+			{
+				task.slot->cond.wait(lock);
+			}
+			
+			if (task.slot->state != PENDING || !preds_done(task))
+			{
+				if (schedstat >= 0)
+					close(schedstat);
+				return; //executive stopped
+			}
+			
+			task.slot->state=RUNNING;
+
+			//mixed criticality: the executive compares the cpu time of the job with its LO budget
+			struct timespec cpu;
+			clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu);
+			task.slot->cpu_start = std::chrono::seconds(cpu.tv_sec) + std::chrono::nanoseconds(cpu.tv_nsec);
+			
+			//debug
+			if (verbose)
+			{
+				std::ostringstream debug;
+				if (task.type == PERIODIC)
+					debug << "Task " << task.id << " RUNNING"<< std::endl;
+				else
+					debug << "Task Aperiodico RUNNING"<< std::endl;
+				std::cout << debug.str();
+			}
+			
+		} 
+
+		//fault injection: the stall delays the job, the overrun extends it
+		std::chrono::nanoseconds stall, overrun;
+		{
+			std::unique_lock<rt::pi_mutex> lock(state_mutex);
+			stall = task.slot->fault_stall;
+			overrun = task.slot->fault_overrun;
+			task.slot->fault_stall = task.slot->fault_overrun = std::chrono::nanoseconds::zero();
+		}
+
+		//arena: the memory of the previous job is released when a new job starts
+		if (task.arena && job_starts(task))
+			task.arena->reset();
+
+		//accounting: the budget of the release is the wcet of the job or of the slice
+		job_usage start = job_usage();
+		std::chrono::nanoseconds budget = task.wcet * unit_time;
+		if (accounting)
+		{
+			if (!task.slice_wcets.empty())
+				budget = task.slice_wcets[task.slot->next_slice] * unit_time;
+			start = usage_now();
+		}
+
+		if (stall.count() > 0)
+			std::this_thread::sleep_for(stall);
+
+		//trace: cpu time of the job's body
+		struct timespec body_start, body_end;
+		if (!trace_path.empty())
+			clock_gettime(CLOCK_THREAD_CPUTIME_ID, &body_start);
+
+		bool counted = false; //hardware counters read around the job
+		if (profile_hyperperiods > 0)
+		{
+			size_t slice = task.slot->next_slice;
+			bool first = !task.resumable || task.slice_first[slice]; //the slices of a resumable job form one sample
+
+			auto start = std::chrono::steady_clock::now();
+			struct timespec cpu_start, cpu_end;
+			clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu_start);
+
+			if (counters)
+				counted = counters->read(job_start);
+
+			run_job(task);
+
+			if (counters)
+				counted = counters->read(job_end) && counted;
+
+			clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu_end);
+			std::chrono::nanoseconds wall(std::chrono::steady_clock::now() - start);
+			std::chrono::nanoseconds cpu((cpu_end.tv_sec - cpu_start.tv_sec) * 1000000000LL + (cpu_end.tv_nsec - cpu_start.tv_nsec));
+
+			record_sample(task, task.slices.empty() ? 0 : slice, first, wall, cpu);
+		}
+		else
+		{
+			if (counters)
+				counted = counters->read(job_start);
+
+			run_job(task);
+
+			if (counters)
+				counted = counters->read(job_end) && counted;
+		}
+
+		if (!trace_path.empty())
+			clock_gettime(CLOCK_THREAD_CPUTIME_ID, &body_end);
+
+		if (overrun.count() > 0)
+			fault_injector::spin(overrun);
+
+		job_usage usage;
+		if (accounting)
+		{
+			usage = usage_now();
+			usage.wall -= start.wall;
+			usage.user -= start.user;
+			usage.kernel -= start.kernel;
+			usage.wait -= start.wait;
+			usage.voluntary -= start.voluntary;
+			usage.involuntary -= start.involuntary;
+		}
+
+		{
+			std::unique_lock<rt::pi_mutex> lock(state_mutex);
+
+			//before IDLE: the miss flag still tells if the executive found the job late
+			if (accounting)
+			{
+				usage.delay = start.wall - task.slot->release.time_since_epoch();
+				account_job(task, usage, budget);
+			}
+
+			if (!trace_path.empty())
+				trace_out.add_job(task.slot->release_frame, task.type == PERIODIC ? task.id : p_tasks.size(),
+					std::chrono::nanoseconds((body_end.tv_sec - body_start.tv_sec) * 1000000000LL + (body_end.tv_nsec - body_start.tv_nsec)));
+
+			//a job with a failed read is not counted (its delta would be meaningless)
+			if (counters && counted)
+			{
+				job_counters & c = task.counters;
+				++c.jobs;
+				for (int e = 0; e < rt::perf_counters::NUM_EVENTS; ++e)
+				{
+					uint64_t value = job_end.value[e] - job_start.value[e];
+					c.total[e] += value;
+					c.max[e] = std::max(c.max[e], value);
+				}
+			}
+
+			task.slot->state = IDLE;
+			task.slot->done_frame = task.slot->release_frame;
+
+			//precedence: the successors released in the frame may start
+			for (uint64_t s = task.slot->succs; s != 0; s &= s - 1)
+				slots[__builtin_ctzll(s)].cond.notify_one();
+
+			//the producer of the request sees the completion at once, not at the end of the frame
+			if (task.type == APERIODIC && ap_from_ring)
+				ring->complete(ap_current.id);
+
+			if (task.type == APERIODIC)
+				ap_completed(ap_arrival, std::chrono::steady_clock::now());
+
+			//the executive waits for the end of a job in the fallback, and of the aperiodic job in its service window
+			if (degraded || task.type == APERIODIC)
+				done_cond.notify_one();
+			
+			//debug
+			if (verbose)
+			{
+				std::ostringstream debug;
+				if (task.type == PERIODIC)
+					debug << "Task " << task.id << " IDLE"<< std::endl;
+				else
+					debug << "Task Aperiodico IDLE"<< std::endl;
+				std::cout << debug.str();
+			}
+		}
+
+	}
+}
+
+//EXECUTIVE THREAD
+void Executive::exec_function()
+{
+	unsigned long frame_id = 0;
+	unsigned long frame_count = 0;
+
+	auto next_frame = clock->start(frame_length*unit_time);
+	auto last = next_frame;
+
+	bool ap_running = false;
+	unsigned int slack_used = 0;
+
+	//mixed criticality: the mode switch is enabled by the HIGH tasks
+	bool mixed = std::any_of(p_tasks.begin(), p_tasks.end(), [](const task_data & t) { return t.level == HIGH; });
+	bool overrun = false; //overruns in the current hyperperiod
+	unsigned long frame_ap_misses = 0; //aperiodic misses at the end of the previous frame (fault injection)
+
+	while (max_frames == 0 || frame_count < max_frames)
+	{
+		auto frame_start = next_frame;
+		current_frame_start = frame_start;
+		auto wakeup = std::chrono::steady_clock::now();
+
+		//one entry of the frame table: tasks and slack time
+		frame_table::frame_view frame = frames[frame_id];
+		unsigned int frame_slack = frames.slack(frame_id);
+		const frame_dag * dag = dags[frame_id].cpu.empty() ? nullptr : &dags[frame_id];
+
+		if (verbose)
+		{
+			std::ostringstream debug;
+			debug << "-----Executive: frame_id " << frame_id <<  " starting-----" << std::endl;			
+			std::cout << debug.str();
+		}
+		
+
+		//backlog: the requests that found the previous aperiodic job running, in arrival order
+		if (ap_backlog_size > 0 && !ap_running)
+		{
+			ap_backlog_entry & waiting = ap_backlog[ap_backlog_head];
+			ap_backlog_head = (ap_backlog_head + 1) % ap_backlog.size();
+			--ap_backlog_size;
+			start_ap_job(ap_running, waiting.request, waiting.from_ring, frame_count, waiting.arrival);
+		}
+
+		//ap_request check
+		{
+			std::unique_lock<rt::pi_mutex> lock(ap_request_mutex);
+			if(ap_request && replaying)
+				ap_request = false; //the requests are the recorded ones
+			else if(ap_request)
+			{
+				release_ap_job(ap_running, ap_local_request, false, frame_count, ap_request_time);
+				ap_request = false;
+			}
+		}
+
+		//requests of the other processes
+		if (ring != nullptr && !replaying)
+			drain_ap_ring(ap_running, frame_count);
+
+		//replay: the recorded requests of the frame, with their arrival times
+		std::chrono::nanoseconds offset;
+		while (replaying && trace_in.next_arrival(frame_count, offset))
+			release_ap_job(ap_running, ap_request_data(), false, frame_count, frame_start + offset);
+
+		//fault injection: burst of aperiodic requests
+		if (faults != nullptr && !replaying)
+			for (unsigned int r = faults->burst(frame_count); r > 0; --r)
+				release_ap_job(ap_running, ap_request_data(), false, frame_count);
+
+
+
+		//SET PRIORITY & WAKE-UP TASK
+		//Tasks' priority is set dinamiccaly in each frame.
+		/**
+		 * PRIORITY MANAGMENT
+		 * 
+		 * Executive has always the maximum priority.
+		 * If in ap_running the policy used is 'slack stealing': during the slack time any periodic task in deadline miss has
+		 * priority equal to (MAX - 1), the aperiodic task has priority (MAX - 2), while the periodic tasks to schedule in the frame
+		 * have lower priority.
+		 * At the end of slack time, when the executive wakes up, the aperiodic task's priority is set to MIN,
+		 * the one of any periodic task in deadline miss to (MIN + 1), while the one of the other periodic task will be higher
+		 * and defined according to the established order execution.
+		 * 
+		 * In particular: if a task is in deadline miss and it has an execution even in the next fram, then its execution is skipped.
+		 * The task in question executes in any remaining time at the end of the frame (and / or in the slack time) in order to avoid
+		 * delaying periodic tasks.
+		 * 
+		 */
+		rt::priority thread_prio(max_prio);
+		thread_prio -= 3;
+		rt::affinity aff(cpus);
+		auto frame_end = frame_start + frame_length*unit_time;
+		bool dispatched = false; //release latency and dispatch time accounted
+		{
+			std::unique_lock<rt::pi_mutex> lock(state_mutex);
+			for (size_t i = 0; i < frame.size(); i++)
+			{
+				if (hi_mode && p_tasks[frame[i]].level == LOW)
+				{
+					++stats.shed_jobs;
+					
+					if (verbose)
+					{
+						std::ostringstream debug;
+						debug << "Task " << p_tasks[frame[i]].id << " SHED (HI mode)"<< std::endl;
+						std::cout<< debug.str();
+					}
+				}
+				else if (slots[frame[i]].state == IDLE)
+				{
+					if (faults != nullptr)
+					{
+						unsigned int overrun, stall;
+						faults->job_faults(frame_count, frame[i], overrun, stall);
+						slots[frame[i]].fault_overrun = overrun * unit_time;
+						slots[frame[i]].fault_stall = stall * unit_time;
+					}
+
+					set_thread_priority(p_tasks[frame[i]].thread, thread_prio);
+					--thread_prio;
+
+					//precedence graph: the job is pinned to its cpu of the list schedule
+					if (dag != nullptr)
+					{
+						rt::affinity one;
+						one.set(dag->cpu[i]);
+						rt::set_affinity(p_tasks[frame[i]].thread, one);
+						slots[frame[i]].preds = dag->preds[i];
+						slots[frame[i]].succs = dag->succs[i];
+					}
+					else
+					{
+						rt::set_affinity(p_tasks[frame[i]].thread, aff);
+						slots[frame[i]].preds = slots[frame[i]].succs = 0;
+					}
+
+					release_slice(p_tasks[frame[i]], frame_id);
+
+					//LET: the job reads the outputs published up to its release
+					if (job_starts(p_tasks[frame[i]]))
+					{
+						slots[frame[i]].job_cancelled = false;
+						for (auto & input: p_tasks[frame[i]].let_inputs)
+							input->latch();
+					}
+
+					slots[frame[i]].cancel.reset();
+					slots[frame[i]].state = PENDING;
+					slots[frame[i]].release = frame_start;
+					slots[frame[i]].release_frame = frame_count;
+					
+					if (verbose)
+					{
+						std::ostringstream debug;
+						debug << "Task " << p_tasks[frame[i]].id << " PENDING"<< std::endl;
+						std::cout<< debug.str();
+					}
+					
+					slots[frame[i]].cond.notify_one();
+
+					if (degraded)
+					{
+						//UNPRIVILEGED FALLBACK: the next job is released when this one ends
+						if (!dispatched)
+						{
+							account_dispatch(frame_start, wakeup);
+							dispatched = true;
+						}
+
+						while (slots[frame[i]].state != IDLE)
+							if (!done_cond.wait_until(lock, frame_end))
+								break;
+
+						if (slots[frame[i]].state != IDLE)
+						{
+							//the job overran the frame: the following jobs of the frame miss their deadline without running
+							for (size_t j = i + 1; j < frame.size(); j++)
+							{
+								if (hi_mode && p_tasks[frame[j]].level == LOW)
+									continue;
+
+								slots[frame[j]].miss = true;
+								++slots[frame[j]].miss_count;
+								++stats.misses;
+								
+								if (verbose)
+								{
+									std::ostringstream debug;
+									debug << "Deadline miss task periodico di ID "<< p_tasks[frame[j]].id << " (not released)" << std::endl;
+									std::cout << debug.str();
+								}
+							}
+							break;
+						}
+					}
+				}
+			}
+		}
+
+		if (!dispatched)
+			account_dispatch(frame_start, wakeup);
+
+		//WAKE-UP APERIODIC (no aperiodic service in the HI mode: a running job only progresses in background)
+		bool ap_service = ap_running && !hi_mode;
+
+		//service policy: the budget is replenished every server period (the polling server only for a pending request)
+		if ((ap_server == POLLING || ap_server == DEFERRABLE) && frame_count % server_period == 0)
+			server_left = ap_server == POLLING && !ap_service ? std::chrono::nanoseconds::zero() : std::chrono::nanoseconds(server_budget * unit_time);
+		if (ap_service && ap_body)
+		{
+			/**
+			 * The executive (MAX priority) resumes the aperiodic coroutine during the slack time, before the periodic
+			 * tasks just released: the job progresses for at most the slack time of the frame.
+			 */
+			slack_used = frame_slack;
+
+			//unprivileged fallback: after the periodic jobs, until the end of the frame
+			run_ap_coroutine(degraded ? frame_end : frame_start + std::chrono::milliseconds(frame_slack*unit_time));
+		}
+		else if (ap_service && deadline_server)
+		{
+			/**
+			 * With SCHED_DEADLINE the kernel throttles the aperiodic server (and the tasks in deadline miss)
+			 * once their budget is consumed: no priority change is needed around the slack time.
+			 */
+			wake_ap_thread(" (deadline server)");
+
+			slack_used = ap_budget;
+		}
+		else if (ap_service && degraded)
+		{
+			//unprivileged fallback: the aperiodic job shares the cpu with the periodic jobs, released after them
+			wake_ap_thread(" (unprivileged)");
+
+			slack_used = frame_slack;
+		}
+		else if (ap_service)
+		{
+			auto slack_end = frame_start + std::chrono::milliseconds(frame_slack*unit_time);
+			serve_ap_job(frame_start, slack_end);
+
+			auto used = std::min(std::chrono::steady_clock::now(), slack_end) - frame_start;
+			slack_used = used > std::chrono::nanoseconds::zero() ? used / unit_time : 0;
+		}
+		else
+		{
+			if (verbose)
+			{
+				std::ostringstream debug;
+				debug << "-----Exec sleeping for FRAME TIME-----" << std::endl;
+				std::cout << debug.str();
+			}
+			
+			slack_used = 0;
+
+			//DOORBELL: a request arriving during the slack time is released at once, for the rest of the slack time
+			auto window_end = frame_start + std::chrono::milliseconds(frame_slack*unit_time);
+			while (!ap_running && !hi_mode && !degraded && doorbell_fd >= 0 && wait_doorbell(window_end))
+				drain_ap_ring(ap_running, frame_count);
+
+			if (ap_running && !hi_mode && !degraded)
+			{
+				auto left = window_end - std::chrono::steady_clock::now();
+				slack_used = left > std::chrono::nanoseconds::zero() ? left / unit_time : 0;
+
+				if (ap_body)
+					run_ap_coroutine(window_end);
+				else if (deadline_server)
+				{
+					wake_ap_thread(" (deadline server)");
+					slack_used = ap_budget;
+				}
+				else
+					serve_ap_job(frame_start, window_end);
+			}
+		}
+
+		//MIXED CRITICALITY: a job beyond its LO budget switches to the HI mode before its deadline
+		if (mixed && !hi_mode && !degraded && lo_budget_exceeded(frame, frame_end))
+		{
+			std::unique_lock<rt::pi_mutex> lock(state_mutex);
+			overrun = true;
+			++stats.budget_switches;
+			enter_hi_mode();
+		}
+
+		//Executive sleeps until the next frame start given by the clock source
+		next_frame = clock->wait_frame();
+		auto next = std::chrono::steady_clock::now();
+		std::chrono::nanoseconds frame_time(next - last);
+		
+		if (verbose)
+		{
+			std::chrono::duration<double, std::milli> elapsed(next - last);
+			
+			std::ostringstream debug2;
+			debug2 << "------Exec: end frame " << elapsed.count() << "-----"<< std::endl << std::endl << std::endl;
+			std::cout << debug2.str();
+		}
+		last = next;
+		
+		//CHECK DEADLINE MISS
+		rt::priority miss_prio(rt::priority::rt_min);
+		++miss_prio;
+		bool nominal = true; //no miss in the frame and no task still in miss
+		
+		{
+			std::unique_lock<rt::pi_mutex> lock(state_mutex);
+			for(size_t i = 0; i < p_tasks.size(); i++)
+			{
+				if((slots[i].miss) && (slots[i].state == IDLE))
+				{
+					slots[i].miss = false;
+				}
+			}
+
+			end_ap_frame(ap_running, frame_count, next);
+
+			for (size_t i = 0; i < frame.size(); i++)
+			{				
+				if (hi_mode && p_tasks[frame[i]].level == LOW)
+					continue; //shed
+
+				//partitioning: a job cut by the end of the window is late even if it completed since
+				if (slots[frame[i]].state != IDLE || slots[frame[i]].window_cut)
+				{
+					//the job still running is past its deadline
+					if (slots[frame[i]].state != IDLE)
+					{
+						slots[frame[i]].cancel.cancel();
+						slots[frame[i]].job_cancelled = true;
+					}
+
+					overrun = true;
+					nominal = false;
+					slots[frame[i]].miss = true;
+					++slots[frame[i]].miss_count;
+					++stats.misses;
+					//the reservations of the other tasks still running in recovery bound the new ones
+					unsigned int recoveries = 0;
+					for (size_t j = 0; j < p_tasks.size(); j++)
+						if (j != frame[i] && slots[j].miss && slots[j].state != IDLE)
+							++recoveries;
+
+					if (deadline_server && recovery_budget > 0 && recoveries < max_recoveries)
+						set_recovery_reservation(p_tasks[frame[i]]);
+					else
+						set_thread_priority(p_tasks[frame[i]].thread, miss_prio);
+					
+					if (verbose)
+					{
+						std::ostringstream debug;
+						debug << "Deadline miss task periodico di ID "<< p_tasks[frame[i]].id << std::endl;
+						std::cout << debug.str();
+					}
+				}
+				else if (verbose)
+				{
+					std::ostringstream debug;
+					debug << "Check miss superato. Task periodico: stato IDLE, ID " << p_tasks[frame[i]].id << std::endl;
+					std::cout << debug.str();
+				}
+				
+			}
+
+			for (auto & slot: slots)
+				slot.window_cut = false;
+
+			if (mixed && overrun && !hi_mode)
+				enter_hi_mode();
+
+			//LET: the outputs of the jobs completed by now become visible in the next frame (not the partial outputs
+			//of a job with a slice returned early on its cancellation)
+			for (size_t i = 0; i < p_tasks.size(); i++)
+			{
+				if (!p_tasks[i].let_outputs.empty() && slots[i].state == IDLE && job_complete(p_tasks[i]) && !slots[i].job_cancelled)
+					for (auto & output: p_tasks[i].let_outputs)
+						output->publish();
+			}
+
+			if (faults != nullptr)
+			{
+				for (size_t i = 0; i < p_tasks.size(); i++)
+					nominal = nominal && !slots[i].miss;
+
+				//the aperiodic load of a burst is recovered once its requests are served in time
+				nominal = nominal && stats.ap_misses == frame_ap_misses && ap_backlog_size == 0 && (ring == nullptr || !ring->waiting());
+				frame_ap_misses = stats.ap_misses;
+
+				faults->frame_end(frame_count, nominal);
+			}
+		}
+
+		if (shm != nullptr)
+			publish_stats(frame_id, ap_running, slack_used, frame_time);
+
+		if (verbose)
+		{
+			std::ostringstream debug3;
+			debug3 << std::endl << std::endl;
+			std::cout << debug3.str();
+		}
+		
+
+		//LATE START: the executive woke up after the start of the next frame
+		unsigned long skipped = 0;
+		std::chrono::nanoseconds late(next - next_frame);
+		if (late >= late_tolerance * unit_time)
+		{
+			++stats.late_starts;
+			stats.max_late_start = std::max(stats.max_late_start, late);
+
+			if (verbose)
+			{
+				std::ostringstream debug;
+				debug << "-----Executive: late start by " << std::chrono::duration<double, std::milli>(late).count() << "ms-----" << std::endl;
+				std::cout << debug.str();
+			}
+
+			if (late_policy == SKIP)
+			{
+				//the late frames are not executed, the executive waits for the first frame on time
+				while (late >= late_tolerance * unit_time && (max_frames == 0 || frame_count + skipped + 1 < max_frames))
+				{
+					unsigned long skipped_frame = frame_count + skipped + 1;
+
+					//the requests of the skipped frame still arrive, its jobs are not released
+					if (faults != nullptr)
+					{
+						faults->skip_frame(skipped_frame);
+						for (unsigned int r = faults->burst(skipped_frame); r > 0; --r)
+							release_ap_job(ap_running, ap_request_data(), false, skipped_frame);
+					}
+
+					next_frame = clock->wait_frame();
+					auto now = std::chrono::steady_clock::now();
+					late = now - next_frame;
+					++skipped;
+
+					std::unique_lock<rt::pi_mutex> lock(state_mutex);
+					end_ap_frame(ap_running, skipped_frame, now);
+
+					//the jobs of the skipped frame miss their deadline without running (the next releases of the sliced
+					//tasks run the slices of their own frames, see release_slice())
+					for (auto id: frames[(frame_id + skipped) % frames.size()])
+					{
+						if (hi_mode && p_tasks[id].level == LOW)
+							continue;
+
+						slots[id].miss = true;
+						++slots[id].miss_count;
+						++stats.misses;
+
+						if (verbose)
+						{
+							std::ostringstream debug;
+							debug << "Deadline miss task periodico di ID "<< p_tasks[id].id << " (frame skipped)" << std::endl;
+							std::cout << debug.str();
+						}
+					}
+				}
+				last = std::chrono::steady_clock::now();
+			}
+			else if (late_policy == SHIFT)
+			{
+				next_frame = clock->shift(next);
+				stats.total_shift += late;
+			}
+		}
+
+		//FRAME ADVANCE (the skipped frames keep their place in the hyperperiod)
+		if (hi_mode)
+			++stats.hi_frames;
+
+		stats.skipped_frames += skipped;
+		for (unsigned long f = 0; f <= skipped; ++f)
+		{
+			++frame_count;
+			if (++frame_id == frames.size())
+			{
+				frame_id = 0;
+
+				//back to the normal mode after a hyperperiod without overruns
+				if (hi_mode && !overrun)
+					leave_hi_mode();
+				overrun = false;
+
+				print_blocking_stats();
+				print_clock_stats();
+			}
+		}
+	}
+
+	//STOP: the tasks end after their current job
+	{
+		std::unique_lock<rt::pi_mutex> lock(state_mutex);
+		stop = true;
+
+		for (auto & slot: slots)
+			slot.cond.notify_one();
+	}
+}
+
+void Executive::enter_hi_mode()
+{
+	hi_mode = true;
+	++stats.mode_switches;
+
+	//the running LOW jobs only progress when no HIGH job is ready
+	rt::priority shed_prio(rt::priority::rt_min);
+	for (size_t i = 0; i < p_tasks.size(); i++)
+	{
+		if (p_tasks[i].level == LOW && slots[i].state != IDLE)
+			set_thread_priority(p_tasks[i].thread, shed_prio);
+	}
+
+	if (verbose)
+	{
+		std::ostringstream debug;
+		debug << "-----Executive: switch to HI criticality mode-----" << std::endl;
+		std::cout << debug.str();
+	}
+}
+
+void Executive::leave_hi_mode()
+{
+	hi_mode = false;
+
+	if (verbose)
+	{
+		std::ostringstream debug;
+		debug << "-----Executive: back to LO criticality mode-----" << std::endl;
+		std::cout << debug.str();
+	}
+}
+
+bool Executive::lo_budget_exceeded(const frame_table::frame_view & frame, std::chrono::steady_clock::time_point until)
+{
+	while (true)
+	{
+		auto now = std::chrono::steady_clock::now();
+		auto next_check = until;
+		bool released = false;
+
+		{
+			std::unique_lock<rt::pi_mutex> lock(state_mutex);
+			for (size_t i = 0; i < frame.size(); i++)
+			{
+				const task_data & task = p_tasks[frame[i]];
+				const task_slot & slot = slots[frame[i]];
+				if (slot.state == IDLE)
+					continue;
+
+				std::chrono::nanoseconds budget = (task.slice_wcets.empty() ? task.wcet : task.slice_wcets[slot.next_slice]) * unit_time;
+				std::chrono::nanoseconds used = std::chrono::nanoseconds::zero();
+				if (slot.state == RUNNING)
+				{
+					struct timespec cpu;
+					clock_gettime(slot.cpu_clock, &cpu);
+					used = std::chrono::seconds(cpu.tv_sec) + std::chrono::nanoseconds(cpu.tv_nsec) - slot.cpu_start;
+				}
+
+				if (used > budget)
+				{
+					if (verbose)
+					{
+						std::ostringstream debug;
+						debug << "Task " << task.id << " beyond its LO budget" << std::endl;
+						std::cout << debug.str();
+					}
+					return true;
+				}
+
+				//the cpu time cannot reach the budget before the wall time does; the checks are a tenth of a unit apart
+				//at least, so that they do not take the cpu from the job near its budget
+				released = true;
+				next_check = std::min(next_check, now + std::max(budget - used, std::chrono::nanoseconds(unit_time) / 10));
+			}
+		}
+
+		if (!released || now >= until)
+			return false;
+
+		std::this_thread::sleep_until(next_check);
+	}
+}
+
+void Executive::run_ap_coroutine(std::chrono::steady_clock::time_point window_end)
+{
+	ap_ctx.window_end = window_end;
+
+	if (!ap_ctx.slack_left())
+		return;
+
+	if (verbose)
+	{
+		std::ostringstream debug;
+		debug << "Task Aperiodico RUNNING (coroutine)" << std::endl;
+		std::cout << debug.str();
+	}
+
+	ap_job.resume();
+
+	//cooperative bound: the coroutine ran past its window, into the time of the periodic jobs
+	std::chrono::nanoseconds overrun(std::chrono::steady_clock::now() - window_end);
+	if (overrun.count() > 0)
+	{
+		++stats.ap_overruns;
+		stats.max_ap_overrun = std::max(stats.max_ap_overrun, overrun);
+
+		if (verbose)
+		{
+			std::ostringstream debug;
+			debug << "Task Aperiodico (coroutine) oltre la slack time di " << std::chrono::duration<double, std::milli>(overrun).count() << " ms" << std::endl;
+			std::cout << debug.str();
+		}
+	}
+
+	if (ap_job.done() && ap_from_ring)
+		ring->complete(ap_current.id);
+
+	if (verbose)
+	{
+		std::ostringstream debug;
+		debug << (ap_job.done() ? "Task Aperiodico IDLE (coroutine)" : "Task Aperiodico SUSPENDED (coroutine)") << std::endl;
+		std::cout << debug.str();
+	}
+}
+
+void Executive::wake_ap_thread(const char * mode)
+{
+	std::unique_lock<rt::pi_mutex> lock(state_mutex);
+	if (ap_task.slot->state == IDLE)
+	{
+		ap_task.slot->state = PENDING;
+		ap_task.slot->release = std::chrono::steady_clock::now();
+		
+		if (verbose)
+		{
+			std::ostringstream debug;
+			debug << "Task Aperiodico PENDING" << mode << std::endl;
+			std::cout<< debug.str();
+		}
+		
+		ap_task.slot->cond.notify_one();
+	}
+}
+
+std::chrono::steady_clock::time_point Executive::steal_slack(std::chrono::steady_clock::time_point frame_start, std::chrono::steady_clock::time_point window_end)
+{
+	rt::priority prio(max_prio);
+	--prio;
+
+	for(size_t i = 0; i < p_tasks.size(); i++)
+	{
+		if(slots[i].miss)
+		{
+			set_thread_priority(p_tasks[i].thread, prio);
+		}
+	}
+
+	--prio;
+	set_thread_priority(ap_task.thread, prio);
+
+	wake_ap_thread("");
+
+	if (verbose)
+	{
+		std::ostringstream debug;
+		debug << "-----Exec Sleeping for SLACK TIME-----" << std::endl;
+		std::cout << debug.str();
+	}
+
+	//Executive sleeps for slack_time, or until the aperiodic job completes if no late periodic job still runs in the window
+	{
+		std::unique_lock<rt::pi_mutex> lock(state_mutex);
+		bool recovering = std::any_of(slots.begin(), slots.end() - 1, [](const task_slot & slot) { return slot.miss && slot.state != IDLE; });
+		if (recovering)
+		{
+			lock.unlock();
+			std::this_thread::sleep_until(window_end);
+		}
+		else
+			while (ap_task.slot->state != IDLE)
+				if (!done_cond.wait_until(lock, window_end))
+					break;
+	}
+	auto end = std::min(std::chrono::steady_clock::now(), window_end);
+	
+	if (verbose)
+	{
+		std::chrono::duration<double, std::milli> elapsed(std::chrono::steady_clock::now() - frame_start);
+
+		std::ostringstream debug1;
+		debug1 << "-----Exec: end slack time" << elapsed.count() << "-----"<< std::endl;
+		std::cout << debug1.str();
+	}
+
+	//Executive wakes up and updates priority to the aperiodic task and to any periodic task in deadline miss.
+	rt::priority ap_prio(rt::priority::rt_min);
+	set_thread_priority(ap_task.thread, ap_prio);
+	
+	++ap_prio;
+	for(size_t i = 0; i < p_tasks.size(); i++)
+	{
+		if(slots[i].miss)
+		{
+			set_thread_priority(p_tasks[i].thread, ap_prio);
+		}
+	}
+
+	return end;
+}
+
+std::chrono::steady_clock::time_point Executive::server_window(std::chrono::steady_clock::time_point window_start, std::chrono::steady_clock::time_point slack_end)
+{
+	if (window_start >= slack_end)
+		return window_start;
+
+	switch (ap_server)
+	{
+		case BACKGROUND:
+			return window_start;
+
+		case POLLING:
+		case DEFERRABLE:
+			return std::min(slack_end, window_start + server_left);
+
+		default:
+			//slack stealing: the whole slack, or the budget of each frame
+			if (server_budget > 0)
+				return std::min(slack_end, window_start + server_budget * unit_time);
+			return slack_end;
+	}
+}
+
+void Executive::serve_ap_job(std::chrono::steady_clock::time_point frame_start, std::chrono::steady_clock::time_point slack_end)
+{
+	auto start = std::max(frame_start, std::chrono::steady_clock::now());
+	auto window_end = server_window(start, slack_end);
+
+	if (window_end <= start)
+	{
+		//no budget or background service: the job runs at MIN priority in the idle time of the frame
+		wake_ap_thread(" (background)");
+		return;
+	}
+
+	auto end = steal_slack(frame_start, window_end);
+
+	if (ap_server == POLLING || ap_server == DEFERRABLE)
+	{
+		std::chrono::nanoseconds used(end - start);
+		server_left = server_left > used ? server_left - used : std::chrono::nanoseconds::zero();
+
+		//the polling server keeps its budget for the pending job only
+		if (ap_server == POLLING && ap_task.slot->state == IDLE)
+			server_left = std::chrono::nanoseconds::zero();
+	}
+}
+
+void Executive::ap_completed(std::chrono::steady_clock::time_point arrival, std::chrono::steady_clock::time_point done)
+{
+	std::chrono::nanoseconds response(done - arrival);
+
+	++stats.ap_jobs;
+	stats.total_ap_response += response;
+	stats.max_ap_response = std::max(stats.max_ap_response, response);
+
+	if (ap_responses.size() < ap_responses.capacity())
+		ap_responses.push_back(response);
+}
+
+void Executive::end_ap_frame(bool & ap_running, unsigned long frame_count, std::chrono::steady_clock::time_point now)
+{
+	if(ap_running && (ap_body ? ap_job.done() : ap_task.slot->state == IDLE))
+	{
+		ap_running = false;
+
+		//the thread records its completion, the coroutine is found complete at the end of the frame
+		if (ap_body)
+			ap_completed(ap_arrival, now);
+	}
+	else if (ap_running && ap_deadline_frame != 0 && ap_deadline_frame <= frame_count + 1)
+	{
+		//counted once, also when the deadline fell in skipped frames
+		ap_deadline_frame = 0;
+		ap_overdue = true;
+
+		ap_task.slot->cancel.cancel();
+		++stats.ap_misses;
+		if (verbose)
+		{
+			std::ostringstream debug;
+			debug << "Deadline miss task aperiodico (richiesta " << ap_current.id << ")" << std::endl;
+			std::cout << debug.str();
+		}
+	}
+}
+
+void Executive::release_ap_job(bool & ap_running, const ap_request_data & request, bool from_ring, unsigned long frame_count, std::chrono::steady_clock::time_point arrival)
+{
+	//the requests of the ring are stamped on CLOCK_MONOTONIC (the steady clock), the others arrive now if not given
+	if (request.sent_ns > 0)
+		arrival = std::chrono::steady_clock::time_point(std::chrono::nanoseconds(request.sent_ns));
+	else if (arrival == std::chrono::steady_clock::time_point())
+		arrival = std::chrono::steady_clock::now();
+
+	//the trace records every request, also the ones lost
+	if (!trace_path.empty())
+	{
+		std::unique_lock<rt::pi_mutex> lock(state_mutex);
+		trace_out.add_arrival(frame_count, arrival - current_frame_start);
+	}
+
+	//the workers of the pool run the aperiodic task out of the executive's slack windows
+	if (pool != nullptr)
+	{
+		if (!pool->submit(ap_task.function, request, from_ring, arrival))
+		{
+			std::unique_lock<rt::pi_mutex> lock(state_mutex);
+			++stats.ap_misses;
+			if (verbose)
+				std::cout << "Aperiodic pool full: request lost" << std::endl;
+		}
+		return;
+	}
+
+	if(ap_running)
+	{
+		ap_job_overdue();
+
+		//the request waits for the running job in the backlog (lost if the backlog is full)
+		if (ap_backlog_size == ap_backlog.size())
+		{
+			++stats.ap_misses;
+			if (verbose)
+				std::cout << "Aperiodic backlog full: request lost" << std::endl;
+			return;
+		}
+
+		ap_backlog[(ap_backlog_head + ap_backlog_size) % ap_backlog.size()] = {request, from_ring, arrival};
+		++ap_backlog_size;
+		return;
+	}
+
+	start_ap_job(ap_running, request, from_ring, frame_count, arrival);
+}
+
+void Executive::start_ap_job(bool & ap_running, const ap_request_data & request, bool from_ring, unsigned long frame_count, std::chrono::steady_clock::time_point arrival)
+{
+	ap_task.slot->cancel.reset();
+	ap_running = true;
+	ap_current = request;
+	ap_from_ring = from_ring;
+	ap_deadline_frame = 0;
+	ap_overdue = false;
+
+	//the deadline counts from the arrival of the request, which may have waited in the ring
+	if (request.deadline > 0)
+	{
+		unsigned long waited = (std::chrono::steady_clock::now() - arrival) / std::chrono::milliseconds(frame_length*unit_time);
+		if (waited < request.deadline)
+			ap_deadline_frame = frame_count + request.deadline - waited;
+		else
+		{
+			ap_task.slot->cancel.cancel();
+			ap_overdue = true;
+			std::unique_lock<rt::pi_mutex> lock(state_mutex);
+			++stats.ap_misses;
+		}
+	}
+
+	ap_arrival = arrival;
+
+	{
+		std::unique_lock<rt::pi_mutex> lock(state_mutex);
+		ap_task.slot->release_frame = frame_count;
+	}
+
+	if (ap_body)
+		ap_job = ap_body(ap_ctx);
+}
+
+void Executive::drain_ap_ring(bool & ap_running, unsigned long frame_count)
+{
+	//the workers of the pool take every request
+	ap_request_data request;
+	while ((pool != nullptr || !ap_running) && ring->pop(request))
+		release_ap_job(ap_running, request, true, frame_count);
+
+	if (ap_running && ring->waiting())
+		ap_job_overdue();
+}
+
+void Executive::ap_job_overdue()
+{
+	//a job without deadline is late once the next request waits for it (the cancelled job gives its slack back)
+	if (ap_deadline_frame != 0 || ap_overdue)
+		return;
+
+	ap_overdue = true;
+	ap_task.slot->cancel.cancel();
+
+	std::unique_lock<rt::pi_mutex> lock(state_mutex);
+	++stats.ap_misses;
+	if (verbose)
+	{
+		std::ostringstream debug;
+		debug << "Deadline miss task aperiodico (richiesta " << ap_current.id << ")" << std::endl;
+		std::cout << debug.str();
+	}
+}
+
+bool Executive::wait_doorbell(std::chrono::steady_clock::time_point window_end)
+{
+	auto left = std::chrono::duration_cast<std::chrono::nanoseconds>(window_end - std::chrono::steady_clock::now());
+	if (left <= std::chrono::nanoseconds::zero())
+		return false;
+
+	struct timespec timeout;
+	timeout.tv_sec = left.count() / 1000000000;
+	timeout.tv_nsec = left.count() % 1000000000;
+
+	struct pollfd fd = {doorbell_fd, POLLIN, 0};
+	if (ppoll(&fd, 1, &timeout, nullptr) <= 0)
+		return false;
+
+	eventfd_t value;
+	eventfd_read(doorbell_fd, &value);
+
+	return true;
+}
+
+void Executive::account_dispatch(std::chrono::steady_clock::time_point frame_start, std::chrono::steady_clock::time_point wakeup)
+{
+	auto now = std::chrono::steady_clock::now();
+	std::chrono::nanoseconds latency(wakeup - frame_start);
+	std::chrono::nanoseconds dispatch(now - wakeup);
+
+	last_latency = latency;
+	last_dispatch = dispatch;
+
+	++stats.frames;
+	stats.total_latency += latency;
+	stats.total_dispatch += dispatch;
+	if (latency > stats.max_latency)
+		stats.max_latency = latency;
+	if (dispatch > stats.max_dispatch)
+		stats.max_dispatch = dispatch;
+}
+
+void Executive::publish_stats(unsigned long frame_id, bool ap_running, unsigned int slack_used, std::chrono::nanoseconds frame_time)
+{
+	shm->begin_write();
+
+	shm->frame_count.store(stats.frames, std::memory_order_relaxed);
+	shm->frame_id.store(frame_id, std::memory_order_relaxed);
+	shm->ap_running.store(ap_running, std::memory_order_relaxed);
+	shm->ap_misses.store(stats.ap_misses, std::memory_order_relaxed);
+	shm->slack.store(frames.slack(frame_id), std::memory_order_relaxed);
+	shm->slack_used.store(slack_used, std::memory_order_relaxed);
+	shm->frame_ns.store(frame_time.count(), std::memory_order_relaxed);
+	shm->latency_ns.store(last_latency.count(), std::memory_order_relaxed);
+	shm->dispatch_ns.store(last_dispatch.count(), std::memory_order_relaxed);
+
+	//miss_count is only written by the executive thread
+	for (size_t i = 0; i < p_tasks.size(); ++i)
+		shm->misses()[i].store(slots[i].miss_count, std::memory_order_relaxed);
+
+	shm->end_write();
+}
+
+void Executive::record_sample(task_data & task, size_t slice, bool first, std::chrono::nanoseconds wall, std::chrono::nanoseconds cpu)
+{
+	task_slot & slot = *task.slot;
+
+	//the slices of a resumable job are accumulated in the job's sample
+	if (!first && slot.sample_count > 0)
+	{
+		task.samples[slot.sample_count - 1].wall += wall;
+		task.samples[slot.sample_count - 1].cpu += cpu;
+	}
+	else if (slot.sample_count < task.samples.size())
+	{
+		job_sample sample = {wall, cpu, slice};
+		task.samples[slot.sample_count++] = sample;
+	}
+}
+
+void Executive::print_profile()
+{
+	const std::chrono::duration<double, std::milli> unit(unit_time);
+
+	//recommended wcet of each task (of each slice, for sliced tasks)
+	std::vector< std::vector<unsigned int> > recommended(p_tasks.size());
+
+	std::ostringstream report;
+	report << "-----WCET PROFILE (" << profile_hyperperiods << " hyperperiods, margin " << profile_margin * 100 << "%)-----" << std::endl;
+	report << std::fixed;
+	report.precision(3);
+	report << "task\tslice\tjobs\twcet\twall max\twall p99\tcpu max\tcpu p99\tcpu p99.9\trecommended wcet" << std::endl;
+
+	auto profile = [&](const task_data & task, size_t samples, size_t slice, unsigned int wcet) -> unsigned int
+	{
+		std::vector<double> wall, cpu;
+		for (size_t i = 0; i < samples; ++i)
+		{
+			if (task.samples[i].slice != slice)
+				continue;
+			wall.push_back(std::chrono::duration<double, std::milli>(task.samples[i].wall).count());
+			cpu.push_back(std::chrono::duration<double, std::milli>(task.samples[i].cpu).count());
+		}
+
+		if (task.type == PERIODIC)
+			report << task.id;
+		else
+			report << "ap";
+		report << "\t" << slice << "\t" << wall.size() << "\t" << wcet;
+
+		if (wall.empty())
+		{
+			report << "\t-" << std::endl;
+			return wcet;
+		}
+
+		std::sort(wall.begin(), wall.end());
+		std::sort(cpu.begin(), cpu.end());
+		auto quantile = [](const std::vector<double> & v, double q) { return v[std::min(v.size() - 1, (size_t) std::ceil(q * v.size()) - 1)]; };
+
+		//the wcet is the job's own demand (cpu time); the wall time, which includes the preemptions and the
+		//blocking caused by the other threads, is only reported
+		double demand = quantile(cpu, 0.999);
+		unsigned int rec = std::max(1.0, std::ceil(demand * (1 + profile_margin) / unit.count()));
+		report << "\t" << wall.back() << "ms\t" << quantile(wall, 0.99) << "ms\t" << cpu.back() << "ms\t"
+			<< quantile(cpu, 0.99) << "ms\t" << demand << "ms\t" << rec << (rec > wcet ? " (exceeds wcet)" : "") << std::endl;
+
+		return rec;
+	};
+
+	for (size_t id = 0; id < p_tasks.size(); ++id)
+	{
+		const task_data & task = p_tasks[id];
+
+		if (!task.slices.empty())
+		{
+			for (size_t k = 0; k < task.slices.size(); ++k)
+				recommended[id].push_back(profile(task, slots[id].sample_count, k, task.slice_wcets[k]));
+		}
+		else
+		{
+			recommended[id].push_back(profile(task, slots[id].sample_count, 0, task.wcet));
+		}
+	}
+	profile(ap_task, ap_task.slot->sample_count, 0, ap_task.wcet);
+
+	//slack per frame with the recommended wcets (resumable tasks keep their budgets)
+	report << "frame\tslack\trecommended slack" << std::endl;
+
+	std::vector<size_t> releases(p_tasks.size(), 0);
+	for (size_t f = 0; f < frames.size(); ++f)
+	{
+		int tot_wcet = 0;
+		for (auto & id: frames[f])
+		{
+			const task_data & task = p_tasks[id];
+
+			if (!task.slices.empty())
+				tot_wcet += recommended[id][releases[id] % task.slices.size()];
+			else if (task.resumable)
+				tot_wcet += task.slice_wcets[releases[id] % task.slice_wcets.size()];
+			else
+				tot_wcet += recommended[id][0];
+			++releases[id];
+		}
+
+		int slack = (int) frame_length - tot_wcet;
+		report << f << "\t" << frames.slack(f) << "\t" << slack << (slack < 0 ? " (overloaded)" : "") << std::endl;
+	}
+
+	std::cout << report.str();
+}
@@ -12,14 +12,37 @@
 #include <chrono>
 #include <thread>
 #include <sstream>
+#include <string>
 #include <mutex>
-#include <condition_variable>
 #include "rt/priority.h"
 #include "rt/affinity.h"
+#include "rt/deadline.h"
+#include "rt/mutex.h"
+#include "rt/perf.h"
+#include "shm_stats.h"
+#include "ap_coroutine.h"
+#include "frame_clock.h"
+#include "ap_ring.h"
+#include "frame_table.h"
+#include "fault_injector.h"
+#include "let_buffer.h"
+#include "exec_trace.h"
+#include "ap_pool.h"
+#include "cancel_token.h"
+#include "job_arena.h"
 
 class Executive
 {
 	public:
+		/* Criticality level of a periodic task */
+		enum criticality {LOW, HIGH};
+
+		/* Service policy of the aperiodic task (see set_ap_server()) */
+		enum ap_policy {SLACK_STEALING, BACKGROUND, POLLING, DEFERRABLE};
+
+		/* Policy of a late executive (see set_overrun_policy()) */
+		enum overrun_policy {CATCH_UP, SKIP, SHIFT};
+
 		/* 
 			Executive initialization and parameters set up:
 			num_tasks: total number of tasks in the schedule;
@@ -35,6 +58,51 @@ class Executive
 			wcet: worst case execution time.
 		*/
 		void set_periodic_task(size_t task_id, std::function<void()> periodic_task, unsigned int wcet);
+
+		/* 
+			As above, with the task's period in units (needed by build_schedule(), 0 otherwise) and criticality level:
+			when a job runs beyond its LO budget (its wcet, or the wcet of its slice, in cpu time of its thread) or
+			misses its deadline, the executive switches to the high criticality mode, where the LOW tasks' jobs
+			and the aperiodic service are shed so that the HIGH tasks keep their deadlines; it goes back to the
+			normal mode at the end of a hyperperiod without overruns. The budgets are checked by the executive during
+			the frame, after its slack window; the HIGH tasks have no separate HI budget (their wcet is the only one).
+			The mode switch is enabled only if at least one task is HIGH.
+		*/
+		void set_periodic_task(size_t task_id, std::function<void()> periodic_task, unsigned int wcet, unsigned int period, criticality level = LOW);
+
+		/*
+			As above, with a body receiving the job's cancellation token (see cancel_token.h), signalled when the job
+			is still running at the end of its frame (a deadline miss).
+		*/
+		void set_periodic_task(size_t task_id, std::function<void(const cancel_token &)> periodic_task, unsigned int wcet, unsigned int period = 0, criticality level = LOW);
+
+		/* 
+			Function to set the criticality level of a task (for sliced and resumable tasks, to call after their set function).
+		*/
+		void set_criticality(size_t task_id, criticality level);
+
+		/* 
+			Function to set a periodic task whose job is split into a sequence of slices (to be called during the schedule's creation):
+			task_id: progressive index of the task, in range [0, num_tasks);
+			slices: ordered list of slice functions; each release of the task in the frames executes the next slice,
+			so the slices of a job run in order and share their state through the captured data (the releases in
+			the hyperperiod must be whole jobs; a release not made, e.g. in miss, skips its slice, so that each
+			frame runs the slice its slack time was computed for);
+			wcets: worst case execution time of each slice;
+			period: task's period, in units (needed only by build_schedule()).
+		*/
+		void set_sliced_task(size_t task_id, std::vector< std::function<void()> > slices, std::vector<unsigned int> wcets, unsigned int period = 0);
+
+		/* 
+			Function to set a periodic task with a resumable body (to be called during the schedule's creation):
+			task_id: progressive index of the task, in range [0, num_tasks);
+			body: function called once per slice with the slice's budget (in units), it must keep its progress
+			between the calls and return true when the job is complete;
+			wcet: worst case execution time of the whole job;
+			period: task's period, in units.
+			The slices' budgets are chosen by build_schedule() according to the free capacity of the frames.
+		*/
+		void set_resumable_task(size_t task_id, std::function<bool(unsigned int)> body, unsigned int wcet, unsigned int period);
 		
 		/* 
 			Function to set the aperiodic task (to call during the schedule's creation):
@@ -42,6 +110,27 @@ class Executive
 			wcet: worst case execution time.
 		*/
 		void set_aperiodic_task(std::function<void()> aperiodic_task, unsigned int wcet);
+
+		/*
+			As above, with a body receiving the job's cancellation token (see cancel_token.h), signalled when the job's
+			deadline passes: at the deadline of a request of the ring or, for a request without deadline, when the next
+			request waits for the job. The waiting requests are released in order at the frame starts after the
+			cancelled job has returned, so the slack time goes to them. The jobs of the pool (set_ap_pool()) are not
+			cancelled.
+		*/
+		void set_aperiodic_task(std::function<void(const cancel_token &)> aperiodic_task, unsigned int wcet);
+
+		/* 
+			Function to set the aperiodic task as a coroutine (alternative to set_aperiodic_task()):
+			aperiodic_task: function creating the coroutine of a job, called when the task is released;
+			wcet: worst case execution time.
+			The executive thread itself resumes the coroutine at the beginning of each frame, for the frame's slack time:
+			the job gives the cpu back with co_await ctx.yield() or ctx.next_frame() (see ap_coroutine.h),
+			so no aperiodic thread and no priority change is needed. The bound is cooperative: the coroutine is not
+			preempted, and code between two suspension points longer than the slack time delays the frame's periodic
+			jobs (counted as ap_overruns in the statistics).
+		*/
+		void set_aperiodic_coroutine(std::function<ap_coroutine(ap_context &)> aperiodic_task, unsigned int wcet);
 		
 		/* 
 			List of tasks to execute in a specific frame (to call during the schedule's creation)
@@ -49,53 +138,697 @@ class Executive
 		*/
 		void add_frame(std::vector<size_t> frame);
 
-		/* Function to execute the application */
-		void run();
+		/*
+			List of tasks of a frame with precedence constraints (to call during the schedule's creation, after set_affinity()):
+			frame: task's ids of the frame, in a topological order of the edges;
+			edges: pairs (a, b) of task's ids of the frame: the job of b starts after the job of a completes.
+			The jobs are assigned to the executive's cpus by list scheduling (the longest path to the end of the frame
+			first): independent jobs run in parallel, each pinned to its cpu, and each job waits for the completion of its
+			predecessors released in the same frame. The frame's slack time is the frame length minus the makespan.
+			At most 64 tasks.
+		*/
+		void add_frame(std::vector<size_t> frame, std::vector<std::pair<size_t, size_t>> edges);
+
+		/* 
+			Function to generate the frames from the tasks' periods (alternative to add_frame(), to call after the tasks are set):
+			jobs are assigned to the frames of the hyperperiod by earliest deadline first (deadline = period),
+			sliced and resumable tasks are split over more frames so that each slice fits the free capacity of its frame.
+			Returns false if no feasible schedule is found.
+		*/
+		bool build_schedule();
+
+		/*
+			Optional: use SCHED_DEADLINE reservations instead of per-frame priority changes (to call before run()):
+			ap_budget: cpu budget per frame (in units) of the aperiodic server;
+			recovery_budget: cpu budget per frame (in units) of each periodic task in deadline miss
+			(0 keeps the background recovery at MIN + 1).
+			The reservations are constant bandwidth servers with the frame as period, not aligned to the frame starts:
+			a server can consume its budget at the end of a frame and again at the start of the next one, so a frame
+			can lose up to twice each budget, and the deadline threads also preempt the executive thread (the delay of
+			its wake-up is included in this interference). Hence 2 * (ap_budget + recovery_budget) must fit in the
+			smallest slack time, and a task in deadline miss gets a recovery reservation only while the reservations
+			running in recovery keep 2 * (ap_budget + n * recovery_budget) within it; the others recover at MIN + 1.
+		*/
+		void set_deadline_server(unsigned int ap_budget, unsigned int recovery_budget = 0);
+
+		/*
+			Optional: service policy of the aperiodic thread (to call before run(), default: SLACK_STEALING with the whole slack).
+			In its service window, from the start of the frame, the aperiodic task runs above the periodic jobs of the frame;
+			otherwise it runs at MIN priority, in the idle time of the frame:
+			SLACK_STEALING: the slack time of each frame (at most budget units, if budget > 0);
+			BACKGROUND: no service window, idle time only;
+			POLLING: budget units replenished every period frames, available only if a request is pending at the
+			replenishment (otherwise lost until the next one) and lost when the job completes;
+			DEFERRABLE: budget units replenished every period frames, kept until used by the requests of the period.
+			A service window never exceeds the slack time of its frame, so the periodic jobs keep their guarantees.
+			The policies apply to the aperiodic thread: the coroutine, the deadline server and the unprivileged
+			fallback keep their own service.
+		*/
+		void set_ap_server(ap_policy policy, unsigned int budget = 0, unsigned int period = 1);
+
+		/*
+			Optional: publish the executive's counters at every frame in the POSIX shared-memory segment "name"
+			(to call before run()), readable by an external monitor (see shm-monitor) without blocking the executive.
+		*/
+		void set_shm_stats(const std::string & name);
+
+		/*
+			Optional: WCET profiling run (to call before run()):
+			hyperperiods: number of hyperperiods executed by run() before returning;
+			margin: relative margin added to the 99.9th percentile of the cpu time in the recommended wcet (0.2: 20%).
+			The execution time of every job (wall and thread cpu time, per slice for sliced tasks) is recorded,
+			and at the end the observed maxima and percentiles, the recommended wcet and the slack per frame
+			resulting from the recommended wcets are printed. The wall time, which includes the preemptions and
+			the blocking by other threads, is reported for information only.
+		*/
+		void set_profiling(unsigned int hyperperiods, double margin = 0.2);
+
+		/*
+			Optional: source of the frame starts (to call before run(), default: monotonic_clock, see frame_clock.h).
+			The clock is not owned by the executive and must outlive run().
+		*/
+		void set_clock_source(frame_clock & source);
+
+		/*
+			Optional: policy of the executive when it wakes up late (to call before run(), default: CATCH_UP), e.g. after
+			a long sequence of priority changes, an SMI or a kernel delay. A start is late when the executive wakes up
+			tolerance units or more after the frame start:
+			CATCH_UP: the frames whose start has passed run back to back, with the time of the delay missing;
+			SKIP: the frames whose start is late by tolerance units or more are not executed (their jobs are not
+			released) and the executive waits for the next frame start, so the frames keep their phase in the hyperperiod;
+			SHIFT: the timeline restarts at the late wake-up, the current and the following frames have their whole length.
+			The late starts are counted in the statistics; with an external cycle (see frame_clock.h) a frame starts late
+			only when its tick was read together with the next ones, and SHIFT behaves as CATCH_UP.
+		*/
+		void set_overrun_policy(overrun_policy policy, unsigned int tolerance = 1);
+
+		/*
+			Optional: cpus of the executive thread and of the task threads (to call before run(), default: cpu 0).
+		*/
+		void set_affinity(const rt::affinity & cpus);
+
+		/*
+			Optional: priority of the executive thread (to call before run(), default: rt_max). The task threads and
+			the aperiodic thread run below it, in the same order; a thread that must preempt the executive (e.g. the
+			partition scheduler, see partition.h) runs above it.
+		*/
+		void set_max_priority(rt::priority prio);
+
+		/*
+			Optional: accept aperiodic requests from other processes through the shared-memory ring "name"
+			(to call before run(), see ap_ring.h):
+			capacity: slots of the ring;
+			doorbell: the producers also write an eventfd, so that a request arriving in a frame without aperiodic
+			job is released at once, for what is left of the frame's slack time, instead of at the next frame start;
+			mode: permissions of the ring's segment (default: producers of the same user only).
+			The ring is drained at each frame boundary without blocking; each request releases the aperiodic task
+			like ap_task_request(), and a job still running after the request's deadline (in frames) is a deadline miss.
+		*/
+		void set_ap_ring(const std::string & name, unsigned int capacity = 64, bool doorbell = false, mode_t mode = 0600);
+
+		/*
+			Logical Execution Time communication (to call during the schedule's creation, see let_buffer.h):
+			the let_buffer "output" written by the task is published at the first frame boundary after the end of the job;
+			the let_input "input" read by the task is latched at the release of its jobs. A sliced or resumable task may
+			write outputs but not read inputs: its jobs span several frames, in which the writer may reuse the latched
+			buffer. The buffers are not owned by the executive and must outlive run().
+		*/
+		void set_let_output(size_t task_id, let_output_port & output);
+		void set_let_input(size_t task_id, let_input_port & input);
+
+		/*
+			Optional: inject the overruns, stalls and aperiodic bursts of the injector (to call before run(), see fault_injector.h).
+			The faults of a job are applied by the task's thread around the job, the bursts at the start of the frame;
+			the recovery latency is printed when run() returns. The injector is not owned by the executive.
+		*/
+		void set_fault_injector(fault_injector & injector);
+
+		/*
+			Optional: execute the aperiodic requests on the workers of the pool instead of the slack windows of the
+			executive's cpus (to call before run(), see ap_pool.h): each request (ap_task_request(), the ring, the
+			fault bursts, the replayed arrivals) is a job of the pool, so several requests may run at the same time and
+			the aperiodic task must be reentrant. The pool's cpus should be disjoint from set_affinity(): the periodic
+			schedule is then not disturbed by the aperiodic load. A request is lost (aperiodic miss) if the pool is full,
+			and a request of the ring completed after its deadline is a miss. run() starts the pool, waits for its
+			jobs and prints its statistics; the pool is not owned by the executive and also accepts background jobs.
+			Not available with the aperiodic coroutine.
+		*/
+		void set_ap_pool(ap_pool & pool);
+
+		/*
+			Optional: record the run in a binary trace (to call before run(), see exec_trace.h): the frame and the offset
+			of the aperiodic requests and the cpu time of the body of each job, written to path when run() returns.
+			capacity: records kept (the last ones); 0: one per job and two requests per frame for a run of a given
+			number of hyperperiods, TRACE_RECORDS for an unbounded run.
+		*/
+		void set_trace_record(const std::string & path, size_t capacity = 0);
+
+		/*
+			Optional: replay a trace recorded with the same number of tasks and frame duration (to call before run()):
+			the recorded arrivals are released at the start of their frames instead of the requests of the run
+			(ap_task_request(), the ring and the fault bursts are ignored) and, if synthetic, the body of each job in the
+			trace is replaced by a loop consuming its recorded cpu time (the jobs not in the trace run their body).
+			Returns false if the trace cannot be read or does not match the executive.
+		*/
+		bool set_trace_replay(const std::string & path, bool synthetic = true);
+
+		/*
+			Optional: per-job cpu accounting (to call before run()): around each job the task's thread samples its cpu time
+			(user and kernel), its voluntary and involuntary context switches (getrusage(RUSAGE_THREAD)) and its run-queue
+			wait (/proc/thread-self/schedstat). Each job that misses its deadline is attributed to a self-overrun (more cpu time
+			than its wcet) or to interference: preemption (mostly run-queue wait) or blocking (mostly neither running nor waiting
+			for the cpu). The totals per task are printed when run() returns.
+		*/
+		void set_accounting(bool enable);
+
+		/*
+			Optional: per-job hardware counters (to call before run()): each task's thread opens a group of counters
+			(cycles, instructions, last level cache misses, branch misses, see rt/perf.h) and reads it around the body
+			of each job, without system calls where the cpu allows it. The totals per task are printed when run()
+			returns, to find the jobs with poor cache behaviour (e.g. to reorder the tasks of a frame).
+			Without counters (no PMU, perf_event_paranoid > 2) the executive runs normally and prints the error.
+		*/
+		void set_perf_counters(bool enable);
+
+		/*
+			Optional: scratch memory of "bytes" for the jobs of a task (to call during the schedule's creation, see
+			job_arena.h): allocated and locked in memory at once, emptied at the start of each job (the first slice of
+			sliced and resumable tasks) and reached from the body with job_arena::current().
+			task_id in range [0, num_tasks), num_tasks for the aperiodic task. The largest use of each arena and its
+			failed allocations are printed when run() returns.
+		*/
+		void set_job_arena(size_t task_id, size_t bytes);
+
+		/*
+			Optional: force the unprivileged fallback mode, otherwise chosen by run() when the real-time priorities
+			are not available (e.g. without CAP_SYS_NICE): all threads stay in SCHED_OTHER and the executive releases
+			the jobs of a frame one at a time, each when the previous one ends (run to completion, in the frame's order);
+			a job still running at the end of the frame is a deadline miss and the following jobs of the frame are not released.
+			The aperiodic task runs after the periodic jobs, and the deadline server is not available.
+			The statistics are marked as degraded.
+		*/
+		void set_unprivileged(bool force);
+
+		/*
+			Optional: enable or disable the debug output (enabled by default).
+		*/
+		void set_verbose(bool enable);
+
+		/* 
+			Function to execute the application:
+			hyperperiods: number of hyperperiods to execute before returning (0: run forever).
+		*/
+		void run(unsigned int hyperperiods = 0);
 		
 		/* 
 			Function to request aperiodic task release (to call during the execution).
 		*/
 		void ap_task_request();
 
+		/*
+			As above, with the type, deadline (in frames, 0: until the next request) and payload of the request,
+			read by the job through ap_current_request(). The id and sent_ns fields are not used. Two requests
+			before the same frame start release one job, for the last one.
+		*/
+		void ap_task_request(const ap_request_data & request);
+
+		/*
+			Request of the current aperiodic job (to call from the aperiodic task): type, deadline and payload
+			of the request read from the ring or given to ap_task_request(), all zero for ap_task_request()
+			without arguments (the request of the calling worker with set_ap_pool()).
+		*/
+		const ap_request_data & ap_current_request() const;
+
+		/* Number of frames in the hyperperiod and slack time (in units) of a frame */
+		size_t num_frames() const;
+		unsigned int slack_time(size_t frame_id) const;
+
+		/* Bytes used by the frame table (see frame_table.h) */
+		size_t schedule_memory() const;
+
+		/*
+			Executive's runtime statistics (to read after run() returns):
+			frames: executed frames;
+			misses: periodic deadline misses;
+			mode_switches: switches to the high criticality mode;
+			budget_switches: switches triggered by a job beyond its LO budget (before its deadline);
+			hi_frames: frames executed in the high criticality mode;
+			shed_jobs: LOW jobs not released in the high criticality mode;
+			degraded: measured in the unprivileged fallback mode (no real-time priorities).
+			latency: delay of the executive's wake-up with respect to the nominal frame start;
+			dispatch: executive's time from the wake-up to the release of the frame's tasks;
+			ap_jobs, ap_response: completed aperiodic jobs and their response time from the request
+			(all the response times are returned by ap_response_times());
+			late_starts: frames started late (see set_overrun_policy()), max_late_start: the largest delay;
+			skipped_frames: frames not executed (SKIP); total_shift: delay added to the timeline (SHIFT);
+			ap_overruns: resumptions of the aperiodic coroutine returning after the end of its slack window,
+			max_ap_overrun: the largest excess (the coroutine is not preempted, see set_aperiodic_coroutine()).
+		*/
+		struct exec_stats
+		{
+			unsigned long frames;
+			unsigned long misses;
+			unsigned long ap_misses;
+			unsigned long mode_switches;
+			unsigned long budget_switches;
+			unsigned long hi_frames;
+			unsigned long shed_jobs;
+			bool degraded;
+			std::chrono::nanoseconds total_latency;
+			std::chrono::nanoseconds max_latency;
+			std::chrono::nanoseconds total_dispatch;
+			std::chrono::nanoseconds max_dispatch;
+			unsigned long ap_jobs;
+			std::chrono::nanoseconds total_ap_response;
+			std::chrono::nanoseconds max_ap_response;
+			unsigned long late_starts;
+			std::chrono::nanoseconds max_late_start;
+			unsigned long skipped_frames;
+			std::chrono::nanoseconds total_shift;
+			unsigned long ap_overruns;
+			std::chrono::nanoseconds max_ap_overrun;
+		};
+
+		exec_stats get_stats() const;
+
+		/* Response times of the aperiodic jobs (to read after run() returns; at most one per frame of the run is kept) */
+		const std::vector<std::chrono::nanoseconds> & ap_response_times() const;
+
+		/*
+			Per-task cpu accounting (to read after run() returns, see set_accounting()):
+			wall: job's response time from its start; cpu: thread cpu time, kernel: the part spent in the kernel;
+			wait: time spent ready in the run queue; voluntary/involuntary: context switches;
+			self_overruns, delayed_misses, preempted_misses, blocked_misses: attribution of the deadline misses;
+			response: from the release by the executive to the completion (its range is the job's response jitter).
+		*/
+		struct job_accounting
+		{
+			unsigned long jobs;
+			std::chrono::nanoseconds total_wall;
+			std::chrono::nanoseconds total_cpu;
+			std::chrono::nanoseconds max_cpu;
+			std::chrono::nanoseconds total_kernel;
+			std::chrono::nanoseconds total_wait;
+			std::chrono::nanoseconds max_wait;
+			unsigned long voluntary;
+			unsigned long involuntary;
+			unsigned long self_overruns;
+			unsigned long delayed_misses;
+			unsigned long preempted_misses;
+			unsigned long blocked_misses;
+			std::chrono::nanoseconds min_response;
+			std::chrono::nanoseconds max_response;
+		};
+
+		/* task_id in range [0, num_tasks), num_tasks for the aperiodic task */
+		job_accounting get_accounting(size_t task_id) const;
+
+		/*
+			Per-task hardware counters (to read after run() returns, see set_perf_counters()), indexed by
+			rt::perf_counters::event: totals and maximum of a job; jobs is 0 if the counters were not available.
+		*/
+		struct job_counters
+		{
+			unsigned long jobs;
+			uint64_t total[rt::perf_counters::NUM_EVENTS];
+			uint64_t max[rt::perf_counters::NUM_EVENTS];
+		};
+
+		/* task_id in range [0, num_tasks), num_tasks for the aperiodic task */
+		job_counters get_counters(size_t task_id) const;
+
+		/* Arena of a task (see set_job_arena(), nullptr if it has none): task_id as above */
+		const job_arena * get_job_arena(size_t task_id) const;
+
 	private:
+		friend class partition_scheduler;
+
 		enum thread_type {PERIODIC, APERIODIC}; //used to print debug info
 		enum thread_state {PENDING, IDLE, RUNNING};
 
-		std::mutex state_mutex;
-		std::mutex ap_request_mutex;
+		//priority inheritance: both are shared between the executive (MAX) and lower priority threads
+		rt::pi_mutex state_mutex;
+		rt::pi_mutex ap_request_mutex;
 
+		/*
+			Per-task dispatch state, written at every release by the executive and by the task's thread.
+			Each slot is aligned to its own cache lines, so that the executive's updates of a task
+			never invalidate the line of a neighbouring task running on another core. The statistics, written once
+			per job, are in task_data.
+		*/
+		struct alignas(64) task_slot
+		{
+			thread_state state;
+			bool miss;
+			bool job_done; //resumable task: the current job is complete
+			bool job_cancelled; //a release of the current job was cancelled (cleared when a job starts)
+			pid_t tid; //kernel thread id, published by the thread itself
+			clockid_t cpu_clock; //cpu-time clock of the thread, published by the thread itself
+			std::chrono::nanoseconds cpu_start; //cpu time of the thread at the start of the running job (with state_mutex)
+			unsigned long miss_count;
+			size_t next_slice; //state preserved between the slices
+			size_t sample_count; //profiling: recorded jobs
+			std::chrono::nanoseconds fault_overrun; //fault injection: cpu time added to the job
+			std::chrono::nanoseconds fault_stall; //fault injection: sleep before the job
+			std::chrono::steady_clock::time_point release; //written by the executive (with state_mutex)
+			unsigned long release_frame; //frame count of the release (with state_mutex)
+			unsigned long done_frame; //frame count of the release of the last completed job (with state_mutex)
+			uint64_t preds; //precedence: tasks to wait for in the frame of the release (with state_mutex)
+			uint64_t succs; //precedence: tasks to notify at the completion (with state_mutex)
+			bool window_cut; //partitioning: demoted at the end of the window, a deadline miss
+			cancel_token cancel; //signalled by the executive at the deadline of the job
+			rt::condition_variable cond;
+		};
+
+		/* Profiling: execution time of a job (or of a slice, for sliced tasks) */
+		struct job_sample
+		{
+			std::chrono::nanoseconds wall;
+			std::chrono::nanoseconds cpu;
+			size_t slice;
+		};
+
+		/*
+			Per-task configuration, read-mostly once the schedule is created.
+		*/
 		struct task_data
 		{
 			std::function<void()> function;
 			unsigned int wcet;
 			std::thread thread;
 			thread_type type;
-			thread_state state;
-			std::condition_variable cond;
 			int id;
-			bool miss;
+			unsigned int period;
+			criticality level;
+			size_t releases; //releases in the frames added so far (the k-th one runs the k-th slice)
+			std::vector<uint32_t> release_frames; //sliced and resumable tasks: frame id of each release
+			std::vector<let_output_port *> let_outputs; //LET: published when a job ends
+			std::vector<let_input_port *> let_inputs; //LET: latched when a job starts
+			std::vector< std::function<void()> > slices; //sliced task: one function per slice
+			std::function<bool(unsigned int)> resumable; //resumable task: body called with the slice budget
+			std::vector<unsigned int> slice_wcets; //wcet (budget) of each release in the frames
+			std::vector<bool> slice_first; //resumable task: release starting a new job
+			std::chrono::nanoseconds dl_budget; //SCHED_DEADLINE runtime per frame (0: SCHED_FIFO)
+			std::chrono::nanoseconds dl_period;
+			task_slot * slot; //dispatch state
+			std::vector<job_sample> samples; //profiling: preallocated by run()
+			job_accounting accounting; //written by the task's thread (with state_mutex)
+			job_counters counters; //written by the task's thread (with state_mutex)
+			rt::priority window_prio; //partitioning: priority before the demotion (with state_mutex)
+			std::unique_ptr<job_arena> arena; //scratch memory of the jobs (nullptr: none)
 		};
 		
 		std::vector<task_data> p_tasks;
 		task_data ap_task;
+
+		std::function<ap_coroutine(ap_context &)> ap_body; //coroutine aperiodic task (empty: aperiodic thread)
+		ap_coroutine ap_job; //current job of the coroutine aperiodic task
+		ap_context ap_ctx;
+		std::vector<task_slot> slots; //dispatch state of the periodic tasks, followed by the aperiodic task's one
 		
-		std::vector< std::vector<size_t> > frames;
-	
-		std::vector<size_t> slack_times; //vector that contains slack times of the different frames
+		frame_table frames; //tasks and slack time of the frames of the hyperperiod
+
+		/* Precedence graph and list schedule of a frame, by position in the frame (see add_frame() with edges) */
+		struct frame_dag
+		{
+			std::vector<uint64_t> preds; //bit per task id
+			std::vector<uint64_t> succs;
+			std::vector<unsigned int> cpu;
+		};
+		std::vector<frame_dag> dags; //by frame id: empty for the sequential frames
 		
 		const unsigned int frame_length; // frames' length
 		const std::chrono::milliseconds unit_time; // unit time duration		
 
 		bool ap_request; //flag to request the activation of the aperiodic task
+		ap_request_data ap_local_request; //request of the last ap_task_request() (with ap_request_mutex)
+
+		bool deadline_server; //budgets enforced through SCHED_DEADLINE
+		unsigned int ap_budget;
+		unsigned int recovery_budget;
+		unsigned int max_recoveries; //recovery reservations that fit the smallest slack time
+
+		bool hi_mode; //high criticality mode (written by the executive thread only)
+
+		bool accounting; //per-job cpu accounting
+		bool perf; //per-job hardware counters
+		std::string perf_error; //first error opening the counters (with state_mutex)
+		bool force_unprivileged;
+		bool degraded; //unprivileged fallback: no real-time priorities, jobs run to completion
+		rt::condition_variable done_cond; //unprivileged fallback: end of a job (with state_mutex)
+
+		rt::affinity cpus; //executive and task threads
+		rt::priority max_prio; //executive thread, the other threads below it (set by run() if not given)
+
+		bool verbose; //debug output
+		bool stop; //set by the executive when run() ends (protected by state_mutex)
+		unsigned long max_frames; //frames to execute (0: forever)
+		exec_stats stats;
+		std::chrono::nanoseconds last_latency;
+		std::chrono::nanoseconds last_dispatch;
+
+		unsigned int profile_hyperperiods; //profiling run (0: disabled)
+		double profile_margin;
+
+		monotonic_clock default_clock;
+		frame_clock * clock; //source of the frame starts
+		overrun_policy late_policy;
+		unsigned int late_tolerance; //units
+
+		std::string shm_name;
+		shm_stats * shm; //shared-memory counters (nullptr: disabled)
+
+		std::string ring_name;
+		unsigned int ring_capacity;
+		bool ring_doorbell;
+		mode_t ring_mode;
+		ap_ring * ring; //external aperiodic requests (nullptr: disabled)
+		int doorbell_fd; //eventfd written by the producers (-1: no doorbell)
+		ap_request_data ap_current; //request of the current aperiodic job
+		bool ap_from_ring; //the current job completes a request of the ring
+		unsigned long ap_deadline_frame; //frame count at the aperiodic job's deadline (0: no deadline)
+		bool ap_overdue; //a request waits for the current job, without deadline (its miss is counted)
+		std::chrono::steady_clock::time_point ap_arrival; //request of the current aperiodic job
+
+		//requests waiting for the running aperiodic job (circular, preallocated)
+		struct ap_backlog_entry
+		{
+			ap_request_data request;
+			bool from_ring;
+			std::chrono::steady_clock::time_point arrival;
+		};
+		static const size_t AP_BACKLOG = 64;
+		std::vector<ap_backlog_entry> ap_backlog;
+		size_t ap_backlog_head;
+		size_t ap_backlog_size;
+		std::chrono::steady_clock::time_point current_frame_start; //written by the executive thread
+		std::chrono::steady_clock::time_point ap_request_time; //last ap_task_request() (with ap_request_mutex)
+		std::vector<std::chrono::nanoseconds> ap_responses; //preallocated by run() (with state_mutex)
+
+		//aperiodic service policy (budget in units, period in frames); the remaining budget is the executive's
+		ap_policy ap_server;
+		unsigned int server_budget;
+		unsigned int server_period;
+		std::chrono::nanoseconds server_left;
+
+		fault_injector * faults; //nullptr: no fault injection
+		ap_pool * pool; //nullptr: aperiodic jobs in the slack windows
+
+		//record and replay (see exec_trace.h)
+		std::string trace_path; //empty: no recording
+		size_t trace_capacity; //records of the ring (0: sized by run())
+		static const size_t TRACE_RECORDS = 1 << 20;
+		exec_trace trace_out; //written with state_mutex
+		exec_trace trace_in;
+		bool replaying;
+		bool replay_synthetic;
 	
+		/**
+		 * Function to check if the real-time priorities can be used (on a probe thread).
+		 */
+		bool rt_permitted();
+
 		/**
 		 * Function to set the thread's priority.
 		 */
 		void set_thread_priority(std::thread &th, rt::priority &p); 
 
-		static void task_function(task_data & task, std::mutex &state_mutex);
+		/**
+		 * Function to move a periodic task in deadline miss into its SCHED_DEADLINE recovery reservation.
+		 */
+		void set_recovery_reservation(task_data &task);
+
+		/**
+		 * Mixed criticality: functions to switch to the high criticality mode (demoting the running LOW jobs)
+		 * and back to the normal mode (the LOW sliced and resumable tasks restart from their first slice).
+		 */
+		void enter_hi_mode();
+		void leave_hi_mode();
+
+		/**
+		 * Mixed criticality: function to watch the cpu time of the frame's jobs until "until" or until they complete.
+		 * Returns true as soon as a job runs beyond its LO budget.
+		 */
+		bool lo_budget_exceeded(const frame_table::frame_view & frame, std::chrono::steady_clock::time_point until);
+
+		/**
+		 * Function to print the blocking time statistics of the executive's mutexes (priority inversion bound).
+		 */
+		void print_blocking_stats();
+
+		/**
+		 * Accounting: function to record a job, attributing its deadline miss (to call with state_mutex), and to print the totals.
+		 */
+		struct job_usage
+		{
+			std::chrono::nanoseconds wall;
+			std::chrono::nanoseconds user;
+			std::chrono::nanoseconds kernel;
+			std::chrono::nanoseconds wait;
+			long voluntary;
+			long involuntary;
+			std::chrono::nanoseconds delay; //from the release to the start of the job
+		};
+
+		void account_job(task_data & task, const job_usage & usage, std::chrono::nanoseconds budget);
+		void print_accounting();
+
+		/**
+		 * Function to print the hardware counters of the jobs.
+		 */
+		void print_counters();
+
+		/**
+		 * Function to print the use of the job arenas.
+		 */
+		void print_arenas();
+
+		/**
+		 * Partitioning (see partition.h): functions to demote the running jobs below every real-time thread at the end
+		 * of the partition's window, returning their number, and to give them back their priority at its next window.
+		 */
+		unsigned int demote();
+		void restore();
+
+		/**
+		 * Function to print the faults injected and the recovery latency.
+		 */
+		void print_fault_stats();
+
+		/**
+		 * Function to print the jobs executed and stolen by the workers of the aperiodic pool.
+		 */
+		void print_pool_stats();
+
+		/**
+		 * Function to print the phase error and drift statistics of the frame clock.
+		 */
+		void print_clock_stats();
+
+		/**
+		 * LET: functions to tell if the next release of the task starts a job and if its last job is complete
+		 * (to call with the task IDLE).
+		 */
+		bool job_starts(const task_data & task) const;
+
+		/**
+		 * Function to set the slice of a sliced or resumable task released in the frame frame_id: the one of its
+		 * release in the frame table (to call with state_mutex, the task IDLE).
+		 */
+		void release_slice(task_data & task, size_t frame_id);
+		bool job_complete(const task_data & task) const;
+
+		/**
+		 * Precedence: function to tell if the predecessors of the task's job released in its frame are complete
+		 * (to call with state_mutex).
+		 */
+		bool preds_done(const task_data & task) const;
+
+		/**
+		 * Function to execute a job (or the next slice of a job) of the task.
+		 */
+		void run_job(task_data & task);
+
+		/**
+		 * Profiling: functions to record the execution time of a job and to print the recommended wcets.
+		 */
+		void record_sample(task_data & task, size_t slice, bool first, std::chrono::nanoseconds wall, std::chrono::nanoseconds cpu);
+		void print_profile();
+
+		void task_function(task_data & task);
 		
 		void exec_function();
+
+		/**
+		 * Function to publish the counters of the frame in the shared-memory segment (no system calls).
+		 */
+		void publish_stats(unsigned long frame_id, bool ap_running, unsigned int slack_used, std::chrono::nanoseconds frame_time);
+
+		/**
+		 * Function to resume the aperiodic coroutine until it suspends or the slack window ends.
+		 */
+		void run_ap_coroutine(std::chrono::steady_clock::time_point window_end);
+
+		/**
+		 * Function to wake up the aperiodic thread (slack stealing and deadline server).
+		 */
+		void wake_ap_thread(const char * mode);
+
+		/**
+		 * Function to run the aperiodic thread in the service window, above the periodic tasks. Returns the end of
+		 * the window: earlier than window_end if the job completes and no periodic task is in deadline miss.
+		 */
+		std::chrono::steady_clock::time_point steal_slack(std::chrono::steady_clock::time_point frame_start, std::chrono::steady_clock::time_point window_end);
+
+		/**
+		 * Service policy: function to compute the end of the service window of the aperiodic thread that may start now
+		 * (window_start if there is none), and to serve the aperiodic job, charging the budget.
+		 */
+		std::chrono::steady_clock::time_point server_window(std::chrono::steady_clock::time_point window_start, std::chrono::steady_clock::time_point slack_end);
+		void serve_ap_job(std::chrono::steady_clock::time_point frame_start, std::chrono::steady_clock::time_point slack_end);
+
+		/**
+		 * Function to record the response time of a completed aperiodic job (to call with state_mutex).
+		 */
+		void ap_completed(std::chrono::steady_clock::time_point arrival, std::chrono::steady_clock::time_point done);
+
+		/**
+		 * Function to check the aperiodic job at the end of a frame: its completion or its deadline miss (to call with state_mutex).
+		 */
+		void end_ap_frame(bool & ap_running, unsigned long frame_count, std::chrono::steady_clock::time_point now);
+
+		/**
+		 * Function to release the aperiodic task for a request (queued in the backlog if the previous job is still running).
+		 */
+		void release_ap_job(bool & ap_running, const ap_request_data & request, bool from_ring, unsigned long frame_count,
+			std::chrono::steady_clock::time_point arrival = std::chrono::steady_clock::time_point());
+
+		/**
+		 * Function to count the deadline miss of an aperiodic job without deadline, once a request waits for it.
+		 */
+		void ap_job_overdue();
+
+		/**
+		 * Function to start the aperiodic job of a request (the previous one has returned).
+		 */
+		void start_ap_job(bool & ap_running, const ap_request_data & request, bool from_ring, unsigned long frame_count,
+			std::chrono::steady_clock::time_point arrival);
+
+		/**
+		 * Function to release the requests of the ring, without blocking. The requests stay in the ring while
+		 * the aperiodic job runs.
+		 */
+		void drain_ap_ring(bool & ap_running, unsigned long frame_count);
+
+		/**
+		 * Function to wait for the doorbell until the end of the slack window. Returns true if it was rung.
+		 */
+		bool wait_doorbell(std::chrono::steady_clock::time_point window_end);
+
+		/**
+		 * Function to account the executive's release latency and dispatch time of a frame.
+		 */
+		void account_dispatch(std::chrono::steady_clock::time_point frame_start, std::chrono::steady_clock::time_point wakeup);
 		
 		
 };
@@ -0,0 +1,209 @@
+/**
+ * @file fault_injector.cpp
+ */
+
+#include <cassert>
+#include <ctime>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+
+#include "fault_injector.h"
+
+fault_injector::fault_injector()
+	: seeded(false), seed(0), overrun_rate(0), max_units(0), burst_rate(0), max_burst(0), episode_start(0), stats()
+{
+}
+
+void fault_injector::add(const fault & f)
+{
+	auto pos = std::upper_bound(faults.begin(), faults.end(), f.frame, [](unsigned long frame, const fault & g) { return frame < g.frame; });
+	faults.insert(pos, f);
+}
+
+void fault_injector::add_overrun(unsigned long frame, size_t task_id, unsigned int units)
+{
+	add({frame, OVERRUN, task_id, units});
+}
+
+void fault_injector::add_stall(unsigned long frame, size_t task_id, unsigned int units)
+{
+	add({frame, STALL, task_id, units});
+}
+
+void fault_injector::add_burst(unsigned long frame, unsigned int requests)
+{
+	add({frame, BURST, 0, requests});
+}
+
+bool fault_injector::load(const std::string & path)
+{
+	std::ifstream script(path);
+	if (!script)
+	{
+		std::cerr << "Error opening the fault script " << path << std::endl;
+		return false;
+	}
+
+	std::string line;
+	for (unsigned int n = 1; std::getline(script, line); ++n)
+	{
+		line = line.substr(0, line.find('#'));
+
+		std::istringstream fields(line);
+		unsigned long frame;
+		std::string type;
+		if (!(fields >> frame))
+			continue; //empty line or comment
+
+		fault f = {frame, BURST, 0, 0};
+		bool ok = bool(fields >> type);
+		if (ok && type == "burst")
+			ok = bool(fields >> f.amount);
+		else if (ok && (type == "overrun" || type == "stall"))
+		{
+			f.type = type == "overrun" ? OVERRUN : STALL;
+			ok = bool(fields >> f.task_id >> f.amount);
+		}
+		else
+			ok = false;
+
+		if (!ok)
+		{
+			std::cerr << path << ":" << n << ": invalid fault \"" << line << "\"" << std::endl;
+			return false;
+		}
+
+		add(f);
+	}
+
+	return true;
+}
+
+void fault_injector::set_random(uint64_t seed, double overrun_rate, unsigned int max_units, double burst_rate, unsigned int max_burst)
+{
+	assert(max_units > 0 || overrun_rate == 0); //It fails if the overruns have no length
+	assert(max_burst >= 2 || burst_rate == 0); //It fails if the bursts are not bursts
+
+	seeded = true;
+	this->seed = seed;
+	this->overrun_rate = overrun_rate;
+	this->max_units = max_units;
+	this->burst_rate = burst_rate;
+	this->max_burst = max_burst;
+}
+
+//uniform draw in [0, 1) from the seed, the frame and the stream (splitmix64)
+double fault_injector::draw(unsigned long frame, uint64_t stream) const
+{
+	uint64_t z = seed ^ (frame * 0x9E3779B97F4A7C15ULL) ^ (stream * 0xD1B54A32D192ED03ULL);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	z = z ^ (z >> 31);
+
+	return (z >> 11) * (1.0 / 9007199254740992.0);
+}
+
+void fault_injector::injected(unsigned long frame)
+{
+	++stats.injected;
+
+	if (!stats.recovering)
+	{
+		stats.recovering = true;
+		++stats.episodes;
+		episode_start = frame;
+	}
+}
+
+void fault_injector::job_faults(unsigned long frame, size_t task_id, unsigned int & overrun, unsigned int & stall)
+{
+	overrun = 0;
+	stall = 0;
+
+	auto it = std::lower_bound(faults.begin(), faults.end(), frame, [](const fault & f, unsigned long frame) { return f.frame < frame; });
+	for (; it != faults.end() && it->frame == frame; ++it)
+	{
+		if (it->type == OVERRUN && it->task_id == task_id)
+			overrun += it->amount;
+		else if (it->type == STALL && it->task_id == task_id)
+			stall += it->amount;
+	}
+
+	if (seeded && overrun_rate > 0 && draw(frame, 2 * task_id + 1) < overrun_rate)
+		overrun += 1 + (unsigned int) (draw(frame, 2 * task_id + 2) * max_units);
+
+	if (overrun > 0 || stall > 0)
+		injected(frame);
+}
+
+unsigned int fault_injector::burst(unsigned long frame)
+{
+	unsigned int requests = 0;
+
+	auto it = std::lower_bound(faults.begin(), faults.end(), frame, [](const fault & f, unsigned long frame) { return f.frame < frame; });
+	for (; it != faults.end() && it->frame == frame; ++it)
+	{
+		if (it->type == BURST)
+			requests += it->amount;
+	}
+
+	//stream 0 is not used by the tasks
+	if (seeded && burst_rate > 0 && draw(frame, 0) < burst_rate)
+		requests += 2 + (unsigned int) (draw(frame, UINT32_MAX) * (max_burst - 1));
+
+	if (requests > 0)
+		injected(frame);
+
+	return requests;
+}
+
+void fault_injector::frame_end(unsigned long frame, bool nominal)
+{
+	if (!stats.recovering || !nominal)
+		return;
+
+	//faults absorbed in the frame where they were injected recover in 0 frames
+	unsigned long frames = frame - episode_start;
+
+	stats.recovering = false;
+	++stats.recovered;
+	stats.total_frames += frames;
+	stats.max_frames = std::max(stats.max_frames, frames);
+}
+
+void fault_injector::skip_frame(unsigned long frame)
+{
+	auto it = std::lower_bound(faults.begin(), faults.end(), frame, [](const fault & f, unsigned long frame) { return f.frame < frame; });
+	for (; it != faults.end() && it->frame == frame; ++it)
+	{
+		if (it->type != BURST)
+			++stats.skipped;
+	}
+
+	frame_end(frame, false);
+}
+
+const std::vector<fault_injector::fault> & fault_injector::scripted() const
+{
+	return faults;
+}
+
+fault_injector::recovery_stats fault_injector::get_stats() const
+{
+	return stats;
+}
+
+void fault_injector::spin(std::chrono::nanoseconds cpu)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+	long long end = now.tv_sec * 1000000000LL + now.tv_nsec + cpu.count();
+
+	do
+	{
+		clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+	}
+	while (now.tv_sec * 1000000000LL + now.tv_nsec < end);
+}
@@ -0,0 +1,110 @@
+/**
+ * @file fault_injector.h
+ */
+
+#ifndef FAULT_INJECTOR_H
+#define FAULT_INJECTOR_H
+
+#include <cstdint>
+#include <cstddef>
+#include <chrono>
+#include <string>
+#include <vector>
+
+/*
+	Deterministic faults injected by the executive (see Executive::set_fault_injector()):
+	overrun: the job of a task consumes the given cpu time after its body;
+	stall: the job of a task sleeps for the given time before its body (no cpu time, like a blocking call);
+	burst: a number of aperiodic requests at the start of a frame.
+	The faults are listed by frame count (frames executed since run(), not the frame id in the hyperperiod), added
+	by the functions below or read from a script, and/or drawn from a seed, so that two runs inject the same faults.
+	The injector also measures the recovery latency: the frames from an injection to the first nominal frame
+	(no deadline miss in the frame and no task still in miss).
+*/
+class fault_injector
+{
+	public:
+		enum fault_type {OVERRUN, STALL, BURST};
+
+		struct fault
+		{
+			unsigned long frame;
+			fault_type type;
+			size_t task_id; //OVERRUN, STALL
+			unsigned int amount; //units (OVERRUN, STALL) or requests (BURST)
+		};
+
+		/*
+			Recovery statistics: faulted jobs and bursts, recovery episodes (faults in the same non nominal
+			interval belong to one episode) and their length in frames.
+		*/
+		struct recovery_stats
+		{
+			unsigned long injected;
+			unsigned long episodes;
+			unsigned long recovered;
+			unsigned long total_frames;
+			unsigned long max_frames;
+			bool recovering; //the last episode has not ended yet
+			unsigned long skipped; //job faults of skipped frames, not injected
+		};
+
+		fault_injector();
+
+		void add_overrun(unsigned long frame, size_t task_id, unsigned int units);
+		void add_stall(unsigned long frame, size_t task_id, unsigned int units);
+		void add_burst(unsigned long frame, unsigned int requests);
+
+		/*
+			Reads the faults from a script, one per line ('#' starts a comment):
+				<frame> overrun <task id> <units>
+				<frame> stall <task id> <units>
+				<frame> burst <requests>
+			Returns false (printing the line) if the file cannot be read or a line is not valid.
+		*/
+		bool load(const std::string & path);
+
+		/*
+			Seeded faults: each job is overrun with probability overrun_rate by 1..max_units units, and each frame
+			has a burst of 2..max_burst aperiodic requests with probability burst_rate (0: none).
+			The draws depend only on the seed, the frame count and the task.
+		*/
+		void set_random(uint64_t seed, double overrun_rate, unsigned int max_units, double burst_rate = 0, unsigned int max_burst = 4);
+
+		/* Executive side: faults of a job (in units) and aperiodic requests of a frame */
+		void job_faults(unsigned long frame, size_t task_id, unsigned int & overrun, unsigned int & stall);
+		unsigned int burst(unsigned long frame);
+
+		/* Executive side: end of a frame, nominal if no task is in deadline miss */
+		void frame_end(unsigned long frame, bool nominal);
+
+		/* Executive side: a frame not executed (late start, SKIP policy): not nominal, its job faults are counted as skipped */
+		void skip_frame(unsigned long frame);
+
+		/* Faults added or read from the script, sorted by frame */
+		const std::vector<fault> & scripted() const;
+
+		recovery_stats get_stats() const;
+
+		/* Consumes the given cpu time of the calling thread (overrun) */
+		static void spin(std::chrono::nanoseconds cpu);
+
+	private:
+		std::vector<fault> faults; //sorted by frame
+
+		bool seeded;
+		uint64_t seed;
+		double overrun_rate;
+		unsigned int max_units;
+		double burst_rate;
+		unsigned int max_burst;
+
+		unsigned long episode_start;
+		recovery_stats stats;
+
+		void add(const fault & f);
+		double draw(unsigned long frame, uint64_t stream) const;
+		void injected(unsigned long frame);
+};
+
+#endif
@@ -0,0 +1,224 @@
+/**
+ * @file frame_clock.cpp
+ */
+
+#include <ctime>
+#include <cerrno>
+#include <unistd.h>
+#include <cstring>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <thread>
+
+#include "frame_clock.h"
+
+static std::chrono::nanoseconds raw_now()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+	return std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec);
+}
+
+frame_clock::frame_clock() : frame(0), stats()
+{
+}
+
+frame_clock::~frame_clock()
+{
+}
+
+frame_clock::clock_stats frame_clock::get_stats() const
+{
+	return stats;
+}
+
+void frame_clock::account(std::chrono::nanoseconds phase_error, std::chrono::nanoseconds frame_duration)
+{
+	std::chrono::nanoseconds abs_error = phase_error < std::chrono::nanoseconds::zero() ? -phase_error : phase_error;
+	std::chrono::nanoseconds jitter = frame_duration > frame ? frame_duration - frame : frame - frame_duration;
+
+	++stats.frames;
+	stats.total_phase_error += abs_error;
+	if (abs_error > stats.max_phase_error)
+		stats.max_phase_error = abs_error;
+	if (jitter > stats.max_jitter)
+		stats.max_jitter = jitter;
+}
+
+frame_clock::time_point frame_clock::shift(time_point start)
+{
+	return start;
+}
+
+// monotonic_clock ...............................................................................
+
+frame_clock::time_point monotonic_clock::start(std::chrono::nanoseconds frame)
+{
+	this->frame = frame;
+	next = last_wakeup = std::chrono::steady_clock::now();
+	return next;
+}
+
+frame_clock::time_point monotonic_clock::wait_frame()
+{
+	next += frame;
+	std::this_thread::sleep_until(next);
+
+	time_point now = std::chrono::steady_clock::now();
+	account(now - next, now - last_wakeup);
+	last_wakeup = now;
+
+	return next;
+}
+
+frame_clock::time_point monotonic_clock::shift(time_point start)
+{
+	next = last_wakeup = start;
+	return next;
+}
+
+// monotonic_raw_clock ...........................................................................
+
+frame_clock::time_point monotonic_raw_clock::start(std::chrono::nanoseconds frame)
+{
+	this->frame = frame;
+	steady_origin = std::chrono::steady_clock::now();
+	raw_origin = raw_now();
+	next = last_wakeup = raw_origin;
+	return steady_origin;
+}
+
+frame_clock::time_point monotonic_raw_clock::wait_frame()
+{
+	next += frame;
+
+	std::chrono::nanoseconds now = raw_now();
+	while (now < next)
+	{
+		std::this_thread::sleep_for(next - now);
+		now = raw_now();
+	}
+
+	//frame start mapped on the steady timeline
+	time_point steady_now = std::chrono::steady_clock::now();
+	time_point start = steady_now - (now - next);
+
+	std::chrono::nanoseconds raw_elapsed = now - raw_origin;
+	std::chrono::nanoseconds steady_elapsed = steady_now - steady_origin;
+	stats.drift_ppm = 1e6 * (steady_elapsed.count() - raw_elapsed.count()) / (double) raw_elapsed.count();
+
+	account(now - next, now - last_wakeup);
+	last_wakeup = now;
+
+	return start;
+}
+
+frame_clock::time_point monotonic_raw_clock::shift(time_point start)
+{
+	//the raw timeline moves by the same delay as the steady one
+	next = last_wakeup = raw_now() - std::chrono::nanoseconds(std::chrono::steady_clock::now() - start);
+	return start;
+}
+
+// external_tick_clock ...........................................................................
+
+external_tick_clock::external_tick_clock(int fd) : fd(fd), eventfd(false), failed(false), counter(nullptr), poll(0), last_count(0), ticks(0), pending(0)
+{
+	//an eventfd returns its counter (its fdinfo has the "eventfd-count:" line), the other descriptors a byte per tick
+	std::ifstream info("/proc/self/fdinfo/" + std::to_string(fd));
+	std::string line;
+	while (!eventfd && std::getline(info, line))
+		eventfd = line.compare(0, 14, "eventfd-count:") == 0;
+}
+
+external_tick_clock::external_tick_clock(const std::atomic<uint64_t> * counter, std::chrono::nanoseconds poll)
+	: fd(-1), eventfd(false), failed(false), counter(counter), poll(poll), last_count(0), ticks(0), pending(0)
+{
+}
+
+uint64_t external_tick_clock::wait_tick()
+{
+	if (counter != nullptr)
+	{
+		uint64_t count;
+		while ((count = counter->load(std::memory_order_acquire)) == last_count)
+			std::this_thread::sleep_for(poll);
+
+		uint64_t consumed = count - last_count;
+		last_count = count;
+		return consumed;
+	}
+
+	if (failed)
+		return 0;
+
+	//a late executive consumes all the pending ticks
+	uint8_t buf[64];
+	ssize_t n;
+	while ((n = read(fd, buf, eventfd ? sizeof(uint64_t) : sizeof(buf))) < 0 && errno == EINTR)
+		;
+
+	if (n <= 0 || (eventfd && n != sizeof(uint64_t)))
+	{
+		std::cerr << "External tick source " << (n == 0 ? "closed" : std::strerror(errno)) << ": frames continue on the steady clock" << std::endl;
+		failed = true;
+		return 0;
+	}
+
+	if (!eventfd)
+		return n;
+
+	uint64_t value;
+	std::memcpy(&value, buf, sizeof(value));
+	return value;
+}
+
+frame_clock::time_point external_tick_clock::start(std::chrono::nanoseconds frame)
+{
+	this->frame = frame;
+
+	if (counter != nullptr)
+		last_count = counter->load(std::memory_order_acquire);
+
+	ticks = 0;
+	pending = 0;
+	wait_tick();
+	origin = last = std::chrono::steady_clock::now();
+	return origin;
+}
+
+frame_clock::time_point external_tick_clock::wait_frame()
+{
+	if (pending == 0)
+	{
+		uint64_t consumed = wait_tick();
+		if (consumed == 0)
+		{
+			//no more ticks: the nominal timeline of the cycle
+			read_time = last + frame;
+			std::this_thread::sleep_until(read_time);
+		}
+		else
+		{
+			read_time = std::chrono::steady_clock::now();
+			pending = consumed - 1;
+			stats.merged_ticks += pending;
+		}
+	}
+	else
+		--pending;
+
+	//the ticks read together arrived one frame apart, the last one before the read
+	time_point tick = read_time - frame * pending;
+	++ticks;
+
+	std::chrono::nanoseconds nominal = frame * ticks;
+	std::chrono::nanoseconds elapsed = tick - origin;
+
+	stats.drift_ppm = 1e6 * (elapsed.count() - nominal.count()) / (double) nominal.count();
+	account(elapsed - nominal, tick - last);
+
+	last = tick;
+	return tick;
+}
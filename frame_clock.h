@@ -0,0 +1,136 @@
+/**
+ * @file frame_clock.h
+ */
+
+#ifndef FRAME_CLOCK_H
+#define FRAME_CLOCK_H
+
+#include <chrono>
+#include <atomic>
+#include <cstdint>
+
+/*
+	Source of the executive's frame starts (see Executive::set_clock_source()).
+	Frame starts are returned on the steady_clock timeline, which the executive also uses for the sleeps inside a frame.
+*/
+class frame_clock
+{
+	public:
+		typedef std::chrono::steady_clock::time_point time_point;
+
+		/*
+			Statistics of the frame starts:
+			phase error: delay of the executive's wake-up with respect to the frame start (internal clocks),
+			or offset of the external tick with respect to the nominal timeline started at the first tick (external clock);
+			jitter: maximum deviation of the interval between two wake-ups (two ticks, external clock) from the nominal frame;
+			drift: rate of the clock with respect to the steady clock (internal clocks) or to the nominal frame (external clock), in ppm;
+			merged_ticks: ticks of an external cycle read together with another one by a late executive (their frames
+			start late, see Executive::set_overrun_policy()).
+		*/
+		struct clock_stats
+		{
+			unsigned long frames;
+			std::chrono::nanoseconds max_phase_error;
+			std::chrono::nanoseconds total_phase_error; //sum of the absolute phase errors
+			std::chrono::nanoseconds max_jitter;
+			double drift_ppm;
+			unsigned long merged_ticks;
+		};
+
+		virtual ~frame_clock();
+
+		/* Called by the executive when it starts: frame is the nominal frame duration. Returns the start of the first frame */
+		virtual time_point start(std::chrono::nanoseconds frame) = 0;
+
+		/* Blocks until the start of the next frame and returns it */
+		virtual time_point wait_frame() = 0;
+
+		/*
+			Late executive (see Executive::set_overrun_policy()): restarts the timeline at start, the start of the current
+			frame, and returns it. An external cycle keeps its ticks (default).
+		*/
+		virtual time_point shift(time_point start);
+
+		clock_stats get_stats() const;
+
+	protected:
+		frame_clock();
+
+		void account(std::chrono::nanoseconds phase_error, std::chrono::nanoseconds frame_duration);
+
+		std::chrono::nanoseconds frame;
+		clock_stats stats;
+};
+
+/*
+	Frames on CLOCK_MONOTONIC (std::chrono::steady_clock): the executive's default.
+*/
+class monotonic_clock : public frame_clock
+{
+	public:
+		time_point start(std::chrono::nanoseconds frame) override;
+		time_point wait_frame() override;
+		time_point shift(time_point start) override;
+
+	private:
+		time_point next;
+		time_point last_wakeup;
+};
+
+/*
+	Frames on CLOCK_MONOTONIC_RAW, which is not slewed by NTP adjustments: the frame timeline follows the raw hardware
+	clock, the sleeps are done on CLOCK_MONOTONIC and corrected on wake-up. The drift between the two clocks is measured.
+*/
+class monotonic_raw_clock : public frame_clock
+{
+	public:
+		time_point start(std::chrono::nanoseconds frame) override;
+		time_point wait_frame() override;
+		time_point shift(time_point start) override;
+
+	private:
+		std::chrono::nanoseconds next; //next frame start, on CLOCK_MONOTONIC_RAW
+		std::chrono::nanoseconds last_wakeup; //on CLOCK_MONOTONIC_RAW
+		std::chrono::nanoseconds raw_origin;
+		time_point steady_origin;
+};
+
+/*
+	Frames started by an external cycle (fieldbus tick, simulation master) produced by another process, one tick per frame:
+	- from a file descriptor: an eventfd (each tick adds 1 to its counter, recognized from /proc/self/fdinfo) or
+	  any other descriptor, such as a pipe or FIFO, where each tick is a byte; the clock blocks reading it;
+	- from a counter in shared memory incremented at each tick: the clock polls it every "poll" interval.
+	Every frame starts at the arrival of its tick, so the executive follows the external cycle without accumulating drift.
+	A late executive reads all the pending ticks at once (the extra ones are counted as merged), and the next calls
+	of wait_frame() return them one by one without blocking, each with its estimated arrival (one frame before the
+	next one): the frames of the cycle and of the executive stay aligned, the late ones are handled by the
+	executive's overrun policy. If the descriptor is closed by the producer (EOF) or fails, the error is
+	reported once and the frames continue on the steady clock, one nominal frame after the other.
+*/
+class external_tick_clock : public frame_clock
+{
+	public:
+		explicit external_tick_clock(int fd);
+		external_tick_clock(const std::atomic<uint64_t> * counter, std::chrono::nanoseconds poll = std::chrono::microseconds(50));
+
+		time_point start(std::chrono::nanoseconds frame) override;
+		time_point wait_frame() override;
+
+	private:
+		uint64_t wait_tick(); //ticks consumed (0: the descriptor is closed or failed)
+
+		int fd;
+		bool eventfd; //the descriptor returns the number of ticks (otherwise one byte per tick)
+		bool failed;
+		const std::atomic<uint64_t> * counter;
+		std::chrono::nanoseconds poll;
+		uint64_t last_count;
+		uint64_t ticks; //returned since the first tick
+		uint64_t pending; //read but not returned yet
+		time_point read_time; //of the pending ticks
+
+		time_point origin; //first tick
+		time_point last;
+};
+
+#endif
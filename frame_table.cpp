@@ -0,0 +1,55 @@
+/**
+ * @file frame_table.cpp
+ */
+
+#include <cassert>
+#include <map>
+
+#include "frame_table.h"
+
+void frame_table::push_back(const std::vector<size_t> & frame, unsigned int slack)
+{
+	assert(frame.size() <= UINT16_MAX && slack <= MAX_SLACK); //It fails if the frame does not fit an entry
+	assert(ids.size() + frame.size() <= UINT32_MAX); //It fails if the table is too big for 32-bit offsets
+
+	entry e;
+	e.offset = ids.size();
+	e.count = frame.size();
+	e.slack = slack;
+	entries.push_back(e);
+
+	for (auto & id: frame)
+	{
+		assert(id < MAX_TASKS); //It fails if the task id does not fit a narrow id
+		ids.push_back(id);
+	}
+}
+
+void frame_table::compress()
+{
+	std::map< std::vector<task_id>, uint32_t > patterns; //ordered tasks of a frame -> offset in the new ids
+	std::vector<task_id> packed;
+
+	for (auto & e: entries)
+	{
+		std::vector<task_id> frame(ids.begin() + e.offset, ids.begin() + e.offset + e.count);
+
+		auto it = patterns.find(frame);
+		if (it == patterns.end())
+		{
+			it = patterns.emplace(frame, packed.size()).first;
+			packed.insert(packed.end(), frame.begin(), frame.end());
+		}
+
+		e.offset = it->second;
+	}
+
+	packed.shrink_to_fit();
+	ids.swap(packed);
+	entries.shrink_to_fit();
+}
+
+size_t frame_table::memory() const
+{
+	return sizeof(frame_table) + entries.capacity() * sizeof(entry) + ids.capacity() * sizeof(task_id);
+}
@@ -0,0 +1,93 @@
+/**
+ * @file frame_table.h
+ */
+
+#ifndef FRAME_TABLE_H
+#define FRAME_TABLE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+/*
+	Schedule of the hyperperiod stored in two flat arrays (compressed sparse rows): the task ids of all frames,
+	one after the other, and one 8-byte entry per frame with the offset of its ids, their number and the frame's slack.
+	Reading a frame at its start touches one entry and the contiguous ids that follow, instead of a separate heap
+	block per frame. compress() makes the frames with the same tasks share their ids.
+*/
+class frame_table
+{
+	public:
+		typedef uint16_t task_id;
+
+		static const size_t MAX_TASKS = UINT16_MAX;
+		static const unsigned int MAX_SLACK = UINT16_MAX;
+
+		/* Read-only view of the task ids of a frame */
+		class frame_view
+		{
+			public:
+				frame_view(const task_id * first, size_t count) : first(first), count(count) {}
+
+				const task_id * begin() const { return first; }
+				const task_id * end() const { return first + count; }
+				size_t size() const { return count; }
+				bool empty() const { return count == 0; }
+				size_t operator[](size_t i) const { return first[i]; }
+
+			private:
+				const task_id * first;
+				size_t count;
+		};
+
+		/* Appends a frame, with its ordered task ids and slack time (in units) */
+		void push_back(const std::vector<size_t> & frame, unsigned int slack);
+
+		size_t size() const;
+		bool empty() const;
+
+		frame_view operator[](size_t frame_id) const;
+		unsigned int slack(size_t frame_id) const;
+
+		/* Stores once the ids of the frames with the same ordered tasks */
+		void compress();
+
+		/* Bytes used by the table */
+		size_t memory() const;
+
+	private:
+		struct entry
+		{
+			uint32_t offset; //first id of the frame in ids
+			uint16_t count;
+			uint16_t slack;
+		};
+
+		std::vector<entry> entries;
+		std::vector<task_id> ids;
+};
+
+// ...............................................................................................
+
+inline size_t frame_table::size() const
+{
+	return entries.size();
+}
+
+inline bool frame_table::empty() const
+{
+	return entries.empty();
+}
+
+inline frame_table::frame_view frame_table::operator[](size_t frame_id) const
+{
+	const entry & e = entries[frame_id];
+	return frame_view(ids.data() + e.offset, e.count);
+}
+
+inline unsigned int frame_table::slack(size_t frame_id) const
+{
+	return entries[frame_id].slack;
+}
+
+#endif
@@ -0,0 +1,100 @@
+/**
+ * @file job_arena.cpp
+ */
+
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+#include <sys/mman.h>
+
+#include "job_arena.h"
+
+static thread_local job_arena * current_arena = nullptr;
+
+job_arena::job_arena(size_t capacity) : buffer(nullptr), size(capacity), offset(0), peak(0), failed(0), is_locked(false)
+{
+	assert(capacity > 0); //It fails if the arena has no memory
+
+	void * p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (p == MAP_FAILED)
+		throw std::bad_alloc();
+	buffer = static_cast<char *>(p);
+
+	//the pages are touched and locked now, the jobs never fault on them
+	std::memset(buffer, 0, size);
+	is_locked = mlock(buffer, size) == 0;
+	if (!is_locked)
+		std::cerr << "Error locking a job arena of " << size << " bytes in memory: " << std::strerror(errno) << std::endl;
+}
+
+job_arena::~job_arena()
+{
+	if (is_locked)
+		munlock(buffer, size);
+	munmap(buffer, size);
+}
+
+void * job_arena::allocate(size_t bytes, size_t alignment)
+{
+	assert(alignment > 0 && (alignment & (alignment - 1)) == 0); //It fails if the alignment is not a power of 2
+
+	size_t start = (offset + alignment - 1) & ~(alignment - 1);
+	if (start > size || bytes > size - start)
+	{
+		++failed;
+		return nullptr;
+	}
+
+	offset = start + bytes;
+	if (offset > peak)
+		peak = offset;
+	return buffer + start;
+}
+
+void job_arena::reset()
+{
+	offset = 0;
+}
+
+size_t job_arena::capacity() const
+{
+	return size;
+}
+
+size_t job_arena::used() const
+{
+	return offset;
+}
+
+size_t job_arena::high_water() const
+{
+	return peak;
+}
+
+unsigned long job_arena::failures() const
+{
+	return failed;
+}
+
+bool job_arena::locked() const
+{
+	return is_locked;
+}
+
+void job_arena::reset_stats()
+{
+	peak = offset;
+	failed = 0;
+}
+
+job_arena * job_arena::current()
+{
+	return current_arena;
+}
+
+void job_arena::set_current(job_arena * arena)
+{
+	current_arena = arena;
+}
@@ -0,0 +1,87 @@
+/**
+ * @file job_arena.h
+ */
+
+#ifndef JOB_ARENA_H
+#define JOB_ARENA_H
+
+#include <cstddef>
+#include <new>
+#include <utility>
+
+/*
+	Frame-scoped scratch memory of a task (see Executive::set_job_arena()): a buffer allocated and locked in memory
+	(mlock) before run(), from which the job bodies allocate in O(1) by moving a pointer, without the global allocator.
+	The executive empties the arena at the start of each job, so nothing allocated by a job survives it and the
+	memory never fragments; the objects are not destroyed (their memory is reused).
+	The body of a job reaches the arena of its task with job_arena::current().
+*/
+class job_arena
+{
+	public:
+		explicit job_arena(size_t capacity);
+		~job_arena();
+
+		job_arena(const job_arena &) = delete;
+		job_arena & operator=(const job_arena &) = delete;
+
+		/* Returns nullptr (a failed allocation, counted) if the arena has not enough space left */
+		void * allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+		template<class T, class... Args>
+		T * make(Args &&... args)
+		{
+			void * p = allocate(sizeof(T), alignof(T));
+			return p != nullptr ? new (p) T(std::forward<Args>(args)...) : nullptr;
+		}
+
+		/* Releases all the allocations (called by the executive at the start of each job) */
+		void reset();
+
+		size_t capacity() const;
+		size_t used() const;
+		size_t high_water() const; //largest use by a job
+		unsigned long failures() const; //failed allocations
+		bool locked() const; //the buffer is locked in memory
+		void reset_stats();
+
+		/* Arena of the job running on the calling thread (nullptr if its task has none) */
+		static job_arena * current();
+		static void set_current(job_arena * arena);
+
+	private:
+		char * buffer;
+		size_t size;
+		size_t offset;
+		size_t peak;
+		unsigned long failed;
+		bool is_locked;
+};
+
+/* Standard allocator on the arena of the current job (e.g. for the containers of a job body), deallocate() does nothing */
+template<class T>
+struct arena_allocator
+{
+	typedef T value_type;
+
+	arena_allocator() noexcept : arena(job_arena::current()) {}
+	explicit arena_allocator(job_arena & arena) noexcept : arena(&arena) {}
+	template<class U> arena_allocator(const arena_allocator<U> & other) noexcept : arena(other.arena) {}
+
+	T * allocate(size_t n)
+	{
+		void * p = arena != nullptr ? arena->allocate(n * sizeof(T), alignof(T)) : nullptr;
+		if (p == nullptr)
+			throw std::bad_alloc();
+		return static_cast<T *>(p);
+	}
+
+	void deallocate(T *, size_t) noexcept {}
+
+	template<class U> bool operator==(const arena_allocator<U> & other) const noexcept { return arena == other.arena; }
+	template<class U> bool operator!=(const arena_allocator<U> & other) const noexcept { return arena != other.arena; }
+
+	job_arena * arena;
+};
+
+#endif
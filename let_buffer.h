@@ -0,0 +1,96 @@
+/**
+ * @file let_buffer.h
+ */
+
+#ifndef LET_BUFFER_H
+#define LET_BUFFER_H
+
+#include <utility>
+
+/*
+	Logical Execution Time (LET) communication between periodic tasks (see Executive::set_let_output() and
+	Executive::set_let_input()).
+	The writer task fills the back buffer of a let_buffer during its job; at the first frame boundary after the
+	job is complete the executive publishes it by exchanging the front and back pointers (no copy). Each reader
+	task has a let_input, latched by the executive at the release of its job to the published buffer, so the job
+	reads the same value however long it runs and whenever the writer runs: the data flow only depends on the
+	frames, and the tasks need no lock.
+	The writer must write the whole value in each job (the back buffer holds the value published two jobs before),
+	and a reader job must complete in its frame: a reader still running after the writer's next job may see
+	the buffer being rewritten (for this reason sliced and resumable tasks cannot be readers).
+*/
+
+/* Executive side: publication of an output and latching of an input */
+class let_output_port
+{
+	public:
+		virtual ~let_output_port() {}
+		virtual void publish() = 0;
+};
+
+class let_input_port
+{
+	public:
+		virtual ~let_input_port() {}
+		virtual void latch() = 0;
+};
+
+template <typename T> class let_input;
+
+template <typename T>
+class let_buffer : public let_output_port
+{
+	public:
+		explicit let_buffer(const T & initial = T()) : buffers{initial, initial}, front(&buffers[0]), back(&buffers[1]), written(false) {}
+
+		let_buffer(const let_buffer &) = delete;
+		let_buffer & operator=(const let_buffer &) = delete;
+
+		/* Writer task: buffer of the output of the current job */
+		T & write()
+		{
+			written = true;
+			return *back;
+		}
+
+		/* Last published value (outside of the tasks, e.g. after run()) */
+		const T & value() const { return *front; }
+
+		void publish() override
+		{
+			if (written)
+			{
+				std::swap(front, back);
+				written = false;
+			}
+		}
+
+	private:
+		T buffers[2];
+		T * front; //published
+		T * back; //written by the current job
+		bool written; //the back buffer has a value to publish
+
+		friend class let_input<T>;
+};
+
+template <typename T>
+class let_input : public let_input_port
+{
+	public:
+		explicit let_input(const let_buffer<T> & source) : source(source), latched(source.front) {}
+
+		let_input(const let_input &) = delete;
+		let_input & operator=(const let_input &) = delete;
+
+		/* Reader task: value published when the current job was released */
+		const T & read() const { return *latched; }
+
+		void latch() override { latched = source.front; }
+
+	private:
+		const let_buffer<T> & source;
+		const T * latched;
+};
+
+#endif
@@ -0,0 +1,199 @@
+/**
+ * @file partition.cpp
+ */
+
+#include <cassert>
+#include <algorithm>
+#include <iostream>
+#include <thread>
+
+#include "partition.h"
+#include "rt/priority.h"
+
+partition_scheduler::partition_scheduler(std::chrono::nanoseconds major_frame) : major_frame(major_frame)
+{
+	assert(major_frame.count() > 0); //It fails if the major frame has no duration
+}
+
+size_t partition_scheduler::add_partition(Executive & exec, unsigned int hyperperiods)
+{
+	assert(hyperperiods > 0); //It fails if the partition would run forever (the scheduler waits for every partition)
+
+	size_t id = partitions.size();
+
+	partition p;
+	p.exec = &exec;
+	p.hyperperiods = hyperperiods;
+	p.clock = std::make_unique<partition_clock>(*this, id);
+	p.window_seq = 0;
+	p.started = false;
+	p.done = false;
+	p.stats = partition_stats();
+	partitions.push_back(std::move(p));
+
+	exec.set_clock_source(*partitions.back().clock);
+
+	//the scheduler must preempt the executive to close its window on time
+	exec.set_max_priority(rt::priority::rt_max - 1);
+
+	return id;
+}
+
+void partition_scheduler::add_window(size_t partition_id, std::chrono::nanoseconds offset, std::chrono::nanoseconds duration)
+{
+	assert(partition_id < partitions.size()); //It fails if partition_id is not correct (out of range)
+	assert(duration.count() > 0 && offset.count() >= 0 && offset + duration <= major_frame); //It fails if the window is not in the major frame
+
+	window w = {partition_id, offset, duration};
+	auto pos = std::upper_bound(windows.begin(), windows.end(), w, [](const window & a, const window & b) { return a.offset < b.offset; });
+
+	assert(pos == windows.end() || offset + duration <= pos->offset); //It fails if the window overlaps the next one
+	assert(pos == windows.begin() || (pos - 1)->offset + (pos - 1)->duration <= offset); //It fails if the window overlaps the previous one
+
+	windows.insert(pos, w);
+}
+
+partition_scheduler::partition_stats partition_scheduler::get_stats(size_t partition_id) const
+{
+	assert(partition_id < partitions.size()); //It fails if partition_id is not correct (out of range)
+
+	return partitions[partition_id].stats;
+}
+
+void partition_scheduler::open_window(size_t partition_id, time_point start, time_point end)
+{
+	std::unique_lock<rt::pi_mutex> lock(mtx);
+
+	partition & p = partitions[partition_id];
+	++p.window_seq;
+	p.window_start = start;
+	p.window_end = end;
+	++p.stats.windows;
+
+	cond.notify_all();
+}
+
+void partition_scheduler::run()
+{
+	for (size_t id = 0; id < partitions.size(); ++id)
+		assert(std::any_of(windows.begin(), windows.end(), [id](const window & w) { return w.partition_id == id; })); //It fails if a partition has no window
+
+	//the scheduler opens and closes the windows above every executive
+	try
+	{
+		rt::this_thread::set_priority(rt::priority::rt_max);
+	}
+	catch(rt::permission_error & e)
+	{
+		std::cerr << "Error setting the partition scheduler's priority" << e.what() << std::endl;
+	}
+
+	std::vector<std::thread> runs;
+	for (size_t id = 0; id < partitions.size(); ++id)
+	{
+		runs.emplace_back([this, id]()
+		{
+			partitions[id].exec->run(partitions[id].hyperperiods);
+
+			std::unique_lock<rt::pi_mutex> lock(mtx);
+			partitions[id].done = true;
+		});
+	}
+
+	//the first major frame starts when every executive waits for its first window
+	{
+		std::unique_lock<rt::pi_mutex> lock(mtx);
+		while (!std::all_of(partitions.begin(), partitions.end(), [](const partition & p) { return p.started; }))
+			cond.wait(lock);
+	}
+
+	time_point origin = std::chrono::steady_clock::now();
+	for (unsigned long major = 0; ; ++major)
+	{
+		{
+			std::unique_lock<rt::pi_mutex> lock(mtx);
+			if (std::all_of(partitions.begin(), partitions.end(), [](const partition & p) { return p.done; }))
+				break;
+		}
+
+		for (const window & w: windows)
+		{
+			partition & p = partitions[w.partition_id];
+			time_point start = origin + major * major_frame + w.offset;
+			time_point end = start + w.duration;
+
+			std::this_thread::sleep_until(start);
+			p.stats.max_latency = std::max(p.stats.max_latency, std::chrono::nanoseconds(std::chrono::steady_clock::now() - start));
+
+			//the jobs cut at the end of the previous window are back before the executive checks them
+			p.exec->restore();
+			open_window(w.partition_id, start, end);
+
+			std::this_thread::sleep_until(end);
+			p.stats.cut_jobs += p.exec->demote();
+		}
+	}
+
+	for (auto & r: runs)
+		r.join();
+}
+
+// partition_clock ...............................................................................
+
+partition_scheduler::partition_clock::partition_clock(partition_scheduler & sched, size_t id) : sched(sched), id(id), seen(0)
+{
+}
+
+frame_clock::time_point partition_scheduler::partition_clock::start(std::chrono::nanoseconds frame)
+{
+	this->frame = frame;
+
+	{
+		std::unique_lock<rt::pi_mutex> lock(sched.mtx);
+		sched.partitions[id].started = true;
+		sched.cond.notify_all();
+	}
+
+	next = wait_window();
+	return next;
+}
+
+frame_clock::time_point partition_scheduler::partition_clock::wait_window()
+{
+	std::unique_lock<rt::pi_mutex> lock(sched.mtx);
+
+	partition & p = sched.partitions[id];
+	while (p.window_seq == seen)
+		sched.cond.wait(lock);
+
+	assert(p.window_end - p.window_start >= frame); //It fails if a window is shorter than a frame of its partition
+
+	seen = p.window_seq;
+	window_end = p.window_end;
+	return p.window_start;
+}
+
+frame_clock::time_point partition_scheduler::partition_clock::wait_frame()
+{
+	time_point prev = next;
+	next += frame;
+
+	if (next + frame <= window_end)
+	{
+		std::this_thread::sleep_until(next);
+		account(std::chrono::steady_clock::now() - next, next - prev);
+		return next;
+	}
+
+	//the rest of the window is idle: the next frame starts with the next window of the partition
+	next = wait_window();
+	account(std::chrono::steady_clock::now() - next, frame);
+	return next;
+}
+
+frame_clock::time_point partition_scheduler::partition_clock::shift(time_point start)
+{
+	//a frame that no longer fits the window moves to the next window at the next wait_frame()
+	next = start;
+	return next;
+}
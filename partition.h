@@ -0,0 +1,118 @@
+/**
+ * @file partition.h
+ */
+
+#ifndef PARTITION_H
+#define PARTITION_H
+
+#include <vector>
+#include <chrono>
+#include <memory>
+#include "executive.h"
+#include "frame_clock.h"
+#include "rt/mutex.h"
+
+/*
+	Time partitioning (ARINC 653 style) of independent applications on the same cpus: each partition is an Executive
+	with its own task set, frame table and aperiodic task, and a major frame is divided into windows, each assigned
+	to a partition. The scheduler repeats the major frame and drives the frame clock of each partition, so that a
+	partition's frames start only inside its windows: a window holds an integer number of frames of its partition
+	(the rest of the window is idle) and the frames of the next window continue the partition's schedule.
+	Temporal isolation: at the end of a window the jobs of the partition still running are demoted below every
+	real-time thread (they may only use the cpu left idle by the other partitions) and are deadline misses; they get
+	their priority back at the next window of the partition, where the executive handles them as usual.
+	The partitions sharing cpus must be given the same cpus (Executive::set_affinity()), must not use the deadline
+	server and must run with real-time priorities (no unprivileged fallback).
+*/
+class partition_scheduler
+{
+	public:
+		explicit partition_scheduler(std::chrono::nanoseconds major_frame);
+
+		/*
+			Adds a partition, executed for the given number of its hyperperiods (the executive's clock source is
+			replaced and its threads run below the scheduler, see Executive::set_max_priority()), and returns its id.
+			The executive is not owned by the scheduler.
+		*/
+		size_t add_partition(Executive & exec, unsigned int hyperperiods);
+
+		/*
+			Adds a window of a partition: offset from the start of the major frame. The windows must not overlap
+			and each must hold at least one frame of its partition.
+		*/
+		void add_window(size_t partition_id, std::chrono::nanoseconds offset, std::chrono::nanoseconds duration);
+
+		/* Runs the partitions until each has executed its hyperperiods */
+		void run();
+
+		/*
+			Statistics of a partition (to read after run() returns):
+			windows: windows started; cut_jobs: jobs demoted at the end of a window;
+			latency: delay of the scheduler's wake-up with respect to the window start.
+		*/
+		struct partition_stats
+		{
+			unsigned long windows;
+			unsigned long cut_jobs;
+			std::chrono::nanoseconds max_latency;
+		};
+
+		partition_stats get_stats(size_t partition_id) const;
+
+	private:
+		typedef std::chrono::steady_clock::time_point time_point;
+
+		struct window
+		{
+			size_t partition_id;
+			std::chrono::nanoseconds offset;
+			std::chrono::nanoseconds duration;
+		};
+
+		/* Frame clock of a partition: frames inside the windows opened by the scheduler */
+		class partition_clock : public frame_clock
+		{
+			public:
+				partition_clock(partition_scheduler & sched, size_t id);
+
+				time_point start(std::chrono::nanoseconds frame) override;
+				time_point wait_frame() override;
+				time_point shift(time_point start) override;
+
+			private:
+				time_point wait_window();
+
+				partition_scheduler & sched;
+				size_t id;
+				unsigned long seen; //last window used
+				time_point next;
+				time_point window_end;
+		};
+
+		struct partition
+		{
+			Executive * exec;
+			unsigned int hyperperiods;
+			std::unique_ptr<partition_clock> clock;
+
+			//current window (with mtx)
+			unsigned long window_seq;
+			time_point window_start;
+			time_point window_end;
+			bool started; //the executive waits for its first window
+			bool done; //run() has returned
+
+			partition_stats stats;
+		};
+
+		std::chrono::nanoseconds major_frame;
+		std::vector<partition> partitions;
+		std::vector<window> windows; //sorted by offset
+
+		rt::pi_mutex mtx;
+		rt::condition_variable cond; //window opened, partition started or done
+
+		void open_window(size_t partition_id, time_point start, time_point end);
+};
+
+#endif
@@ -0,0 +1,34 @@
+
+#ifndef RT_DEADLINE_H
+#define RT_DEADLINE_H
+
+#include <chrono>
+#include <sys/types.h>
+
+#include "priority.h"
+
+namespace rt
+{
+
+/*
+	SCHED_DEADLINE (constant bandwidth server) reservations: the kernel grants
+	'runtime' of cpu time every 'period', to be consumed before 'deadline'
+	(runtime <= deadline <= period), and throttles the thread once its budget is exhausted.
+	The thread is identified by its kernel id, which a std::thread does not expose:
+	threads publish it with this_thread::get_tid().
+	Note: a deadline thread cannot be pinned to a subset of the cpus of its root domain.
+*/
+void set_deadline_params(pid_t tid, std::chrono::nanoseconds runtime, std::chrono::nanoseconds deadline,
+	std::chrono::nanoseconds period); // throw (permission_error)
+
+namespace this_thread
+{
+pid_t get_tid();
+
+void set_deadline_params(std::chrono::nanoseconds runtime, std::chrono::nanoseconds deadline,
+	std::chrono::nanoseconds period); // throw (permission_error)
+}
+
+}
+
+#endif
@@ -0,0 +1,149 @@
+
+#ifndef RT_MUTEX_H
+#define RT_MUTEX_H
+
+#include <pthread.h>
+#include <chrono>
+#include <mutex>
+
+#include "priority.h"
+
+namespace rt
+{
+
+/*
+	Contention statistics of a mutex: how many times lock() had to block and for how long.
+	The maximum blocking time bounds the priority inversion suffered by the lockers.
+	Statistics are updated while holding the mutex.
+*/
+struct mutex_stats
+{
+	unsigned long acquisitions;
+	unsigned long contentions;
+	std::chrono::nanoseconds total_blocking;
+	std::chrono::nanoseconds max_blocking;
+};
+
+namespace detail
+{
+
+class basic_mutex
+{
+	public:
+		~basic_mutex();
+
+		basic_mutex(const basic_mutex &) = delete;
+		basic_mutex & operator =(const basic_mutex &) = delete;
+
+		void lock(); // throw (permission_error)
+		bool try_lock();
+		void unlock();
+
+		// to call while holding the mutex (or when no thread uses it)
+		mutex_stats stats() const;
+		void reset_stats();
+
+		pthread_mutex_t * native_handle();
+
+	protected:
+		basic_mutex(int protocol, int ceiling);
+
+	private:
+		pthread_mutex_t mtx;
+		mutex_stats st;
+};
+
+}
+
+/*
+	Mutex with priority inheritance (PTHREAD_PRIO_INHERIT): the owner runs at the priority
+	of the highest priority thread blocked on it.
+*/
+class pi_mutex : public detail::basic_mutex
+{
+	public:
+		pi_mutex();
+};
+
+/*
+	Mutex with immediate priority ceiling (PTHREAD_PRIO_PROTECT): the owner runs at the ceiling
+	priority, which must be at least the priority of every thread using the mutex.
+	Locking it from a thread with higher priority than the ceiling fails with permission_error.
+*/
+class ceiling_mutex : public detail::basic_mutex
+{
+	public:
+		explicit ceiling_mutex(const priority & ceiling);
+};
+
+/*
+	Condition variable usable with pi_mutex and ceiling_mutex
+	(std::condition_variable only works with std::mutex, while std::condition_variable_any
+	relies on an internal mutex without priority inheritance).
+*/
+class condition_variable
+{
+	public:
+		condition_variable();
+		~condition_variable();
+
+		condition_variable(const condition_variable &) = delete;
+		condition_variable & operator =(const condition_variable &) = delete;
+
+		void notify_one();
+		void notify_all();
+
+		template <class Mutex>
+		void wait(std::unique_lock<Mutex> & lock);
+
+		// returns false if abs_time passed without a notification (steady clock: the condition uses CLOCK_MONOTONIC)
+		template <class Mutex, class Duration>
+		bool wait_until(std::unique_lock<Mutex> & lock, const std::chrono::time_point<std::chrono::steady_clock, Duration> & abs_time);
+
+	private:
+		pthread_cond_t cond;
+};
+
+// ...............................................................................................
+
+inline pthread_mutex_t * detail::basic_mutex::native_handle()
+{
+	return &mtx;
+}
+
+inline mutex_stats detail::basic_mutex::stats() const
+{
+	return st;
+}
+
+inline void condition_variable::notify_one()
+{
+	pthread_cond_signal(&cond);
+}
+
+inline void condition_variable::notify_all()
+{
+	pthread_cond_broadcast(&cond);
+}
+
+template <class Mutex>
+inline void condition_variable::wait(std::unique_lock<Mutex> & lock)
+{
+	pthread_cond_wait(&cond, lock.mutex()->native_handle());
+}
+
+template <class Mutex, class Duration>
+inline bool condition_variable::wait_until(std::unique_lock<Mutex> & lock, const std::chrono::time_point<std::chrono::steady_clock, Duration> & abs_time)
+{
+	auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(abs_time.time_since_epoch()).count();
+
+	struct timespec ts;
+	ts.tv_sec = ns / 1000000000;
+	ts.tv_nsec = ns % 1000000000;
+
+	return pthread_cond_timedwait(&cond, lock.mutex()->native_handle(), &ts) == 0;
+}
+
+}
+
+#endif
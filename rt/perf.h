@@ -0,0 +1,80 @@
+#ifndef RT_PERF_H
+#define RT_PERF_H
+
+#include <cstdint>
+#include <string>
+
+namespace rt
+{
+
+/*
+	Hardware counters of the calling thread (perf_event_open), opened as one group so that the kernel
+	schedules them together: cycles, instructions, last level cache misses and branch misses, counted
+	in user space only (allowed by perf_event_paranoid <= 2 for the own threads).
+	If the cpu exposes its counters to user space (x86 rdpmc enabled in the mmap page of the event),
+	read() takes no system call; otherwise it reads the whole group with one read().
+	The counters must be opened and read by the same thread. The events not supported by the cpu
+	(e.g. in a virtual machine) read as 0; if no event can be opened the group is not available
+	and error() tells why: the construction never throws, so that the counters stay optional.
+*/
+class perf_counters
+{
+	public:
+		enum event {CYCLES, INSTRUCTIONS, LLC_MISSES, BRANCH_MISSES, NUM_EVENTS};
+
+		struct sample
+		{
+			uint64_t value[NUM_EVENTS];
+		};
+
+		perf_counters();
+		~perf_counters();
+
+		perf_counters(const perf_counters &) = delete;
+		perf_counters & operator=(const perf_counters &) = delete;
+
+		bool available() const;
+		bool supported(event e) const;
+		bool user_read() const; //read through rdpmc
+		const std::string & error() const;
+
+		/* Current values of the counters (since the group was opened); false if they cannot be read (the values are then 0) */
+		bool read(sample & s) const;
+
+		static const char * name(event e);
+
+	private:
+		int fd[NUM_EVENTS]; //-1: not supported
+		void * page[NUM_EVENTS]; //mmap page of the event (rdpmc)
+		int leader;
+		bool rdpmc;
+		std::string err;
+
+		bool read_user(sample & s) const;
+};
+
+// ...............................................................................................
+
+inline bool perf_counters::available() const
+{
+	return leader >= 0;
+}
+
+inline bool perf_counters::supported(event e) const
+{
+	return fd[e] >= 0;
+}
+
+inline bool perf_counters::user_read() const
+{
+	return rdpmc;
+}
+
+inline const std::string & perf_counters::error() const
+{
+	return err;
+}
+
+}
+
+#endif
@@ -0,0 +1,108 @@
+
+#include <pthread.h>
+#include <sched.h>
+#include <cstring>
+#include <cerrno>
+
+#include "mutex.h"
+
+namespace rt
+{
+
+namespace detail
+{
+
+basic_mutex::basic_mutex(int protocol, int ceiling) : st()
+{
+	pthread_mutexattr_t attr;
+
+	pthread_mutexattr_init(&attr);
+	pthread_mutexattr_setprotocol(&attr, protocol);
+
+	if (protocol == PTHREAD_PRIO_PROTECT)
+		pthread_mutexattr_setprioceiling(&attr, ceiling);
+
+	pthread_mutex_init(&mtx, &attr);
+	pthread_mutexattr_destroy(&attr);
+}
+
+basic_mutex::~basic_mutex()
+{
+	pthread_mutex_destroy(&mtx);
+}
+
+void basic_mutex::lock()
+{
+	int res = pthread_mutex_trylock(&mtx);
+
+	if (res == EBUSY)
+	{
+		auto start = std::chrono::steady_clock::now();
+
+		res = pthread_mutex_lock(&mtx);
+
+		if (res == 0)
+		{
+			std::chrono::nanoseconds blocking(std::chrono::steady_clock::now() - start);
+
+			++st.contentions;
+			st.total_blocking += blocking;
+			if (blocking > st.max_blocking)
+				st.max_blocking = blocking;
+		}
+	}
+
+	if (res != 0)
+	{
+		char msg[30];
+		throw permission_error(strerror_r(res, msg, 30));
+	}
+
+	++st.acquisitions;
+}
+
+bool basic_mutex::try_lock()
+{
+	if (pthread_mutex_trylock(&mtx) != 0)
+		return false;
+
+	++st.acquisitions;
+	return true;
+}
+
+void basic_mutex::unlock()
+{
+	pthread_mutex_unlock(&mtx);
+}
+
+void basic_mutex::reset_stats()
+{
+	st = mutex_stats();
+}
+
+}
+
+pi_mutex::pi_mutex() : detail::basic_mutex(PTHREAD_PRIO_INHERIT, 0)
+{
+}
+
+ceiling_mutex::ceiling_mutex(const priority & ceiling)
+	: detail::basic_mutex(PTHREAD_PRIO_PROTECT, (ceiling - priority::rt_min) + sched_get_priority_min(SCHED_FIFO))
+{
+}
+
+condition_variable::condition_variable()
+{
+	pthread_condattr_t attr;
+	pthread_condattr_init(&attr);
+	pthread_condattr_setclock(&attr, CLOCK_MONOTONIC); //same clock of std::chrono::steady_clock (wait_until())
+	pthread_cond_init(&cond, &attr);
+	pthread_condattr_destroy(&attr);
+}
+
+condition_variable::~condition_variable()
+{
+	pthread_cond_destroy(&cond);
+}
+
+}
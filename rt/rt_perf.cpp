@@ -0,0 +1,178 @@
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <cstring>
+#include <cerrno>
+
+#include "perf.h"
+
+namespace rt
+{
+
+namespace detail
+{
+
+static const struct
+{
+	uint32_t type;
+	uint64_t config;
+} perf_events[perf_counters::NUM_EVENTS] =
+{
+	{PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+	{PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+	{PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES}, //last level cache
+	{PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+};
+
+static int perf_event_open(struct perf_event_attr * attr, int group_fd)
+{
+	//calling thread, any cpu
+	return syscall(SYS_perf_event_open, attr, 0, -1, group_fd, 0);
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+static inline uint64_t rdpmc(uint32_t counter)
+{
+	uint32_t lo, hi;
+	asm volatile("rdpmc" : "=a" (lo), "=d" (hi) : "c" (counter));
+	return lo | ((uint64_t) hi << 32);
+}
+#endif
+
+}
+
+perf_counters::perf_counters() : leader(-1), rdpmc(false)
+{
+	for (int e = 0; e < NUM_EVENTS; ++e)
+	{
+		fd[e] = -1;
+		page[e] = nullptr;
+
+		struct perf_event_attr attr;
+		std::memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = detail::perf_events[e].type;
+		attr.config = detail::perf_events[e].config;
+		attr.read_format = PERF_FORMAT_GROUP;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+
+		fd[e] = detail::perf_event_open(&attr, leader);
+		if (fd[e] < 0)
+		{
+			char msg[64];
+			if (err.empty())
+				err = std::string(name(event(e))) + ": " + strerror_r(errno, msg, sizeof(msg));
+			continue;
+		}
+
+		if (leader < 0)
+			leader = fd[e];
+	}
+
+	if (leader < 0)
+		return;
+
+	err.clear();
+
+#if defined(__x86_64__) || defined(__i386__)
+	//user space reads only if every event of the group allows them
+	rdpmc = true;
+	for (int e = 0; e < NUM_EVENTS; ++e)
+	{
+		if (fd[e] < 0)
+			continue;
+
+		page[e] = mmap(nullptr, sysconf(_SC_PAGESIZE), PROT_READ, MAP_SHARED, fd[e], 0);
+		if (page[e] == MAP_FAILED)
+		{
+			page[e] = nullptr;
+			rdpmc = false;
+		}
+		else if (!static_cast<struct perf_event_mmap_page *>(page[e])->cap_user_rdpmc)
+			rdpmc = false;
+	}
+#endif
+}
+
+perf_counters::~perf_counters()
+{
+	for (int e = 0; e < NUM_EVENTS; ++e)
+	{
+		if (page[e] != nullptr)
+			munmap(page[e], sysconf(_SC_PAGESIZE));
+
+		if (fd[e] >= 0)
+			close(fd[e]);
+	}
+}
+
+bool perf_counters::read_user(sample & s) const
+{
+#if defined(__x86_64__) || defined(__i386__)
+	for (int e = 0; e < NUM_EVENTS; ++e)
+	{
+		s.value[e] = 0;
+		if (fd[e] < 0)
+			continue;
+
+		volatile struct perf_event_mmap_page * pc = static_cast<struct perf_event_mmap_page *>(page[e]);
+		uint32_t seq;
+		uint64_t count;
+		do
+		{
+			seq = pc->lock;
+			asm volatile("" ::: "memory");
+
+			uint32_t index = pc->index;
+			if (index == 0)
+				return false; //not on the cpu now (e.g. multiplexed): the kernel has the value
+
+			uint16_t width = pc->pmc_width;
+			int64_t pmc = detail::rdpmc(index - 1);
+			pmc <<= 64 - width;
+			pmc >>= 64 - width; //sign extension of the raw counter
+
+			count = pc->offset + pmc;
+			asm volatile("" ::: "memory");
+		}
+		while (pc->lock != seq);
+
+		s.value[e] = count;
+	}
+
+	return true;
+#else
+	return false;
+#endif
+}
+
+bool perf_counters::read(sample & s) const
+{
+	if (rdpmc && read_user(s))
+		return true;
+
+	//group read: number of events, then the values in the order of opening
+	uint64_t buf[1 + NUM_EVENTS] = {};
+	bool ok = leader >= 0 && ::read(leader, buf, sizeof(buf)) > 0;
+	if (!ok)
+		buf[0] = 0;
+
+	uint64_t n = 0;
+	for (int e = 0; e < NUM_EVENTS; ++e)
+	{
+		s.value[e] = 0;
+		if (fd[e] >= 0 && n < buf[0])
+			s.value[e] = buf[1 + n++];
+	}
+	return ok;
+}
+
+const char * perf_counters::name(event e)
+{
+	static const char * names[NUM_EVENTS] = {"cycles", "instructions", "llc-misses", "branch-misses"};
+	return names[e];
+}
+
+}
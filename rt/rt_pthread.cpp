@@ -8,10 +8,19 @@
 
 #include <pthread.h>
 #include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
 #include <cstring>
+#include <cerrno>
+#include <cstdint>
 
 #include "priority.h"
 #include "affinity.h"
+#include "deadline.h"
+
+#ifndef SCHED_DEADLINE
+#define SCHED_DEADLINE 6
+#endif
 
 namespace rt
 {
@@ -103,6 +112,46 @@ static void set_affinity(pthread_t pthread_id, const affinity & a)
 #endif
 }
 
+// layout of the kernel's struct sched_attr (not exported by glibc)
+struct sched_attr
+{
+	uint32_t size;
+	uint32_t sched_policy;
+	uint64_t sched_flags;
+	int32_t sched_nice;
+	uint32_t sched_priority;
+	uint64_t sched_runtime;
+	uint64_t sched_deadline;
+	uint64_t sched_period;
+};
+
+static void set_deadline_params(pid_t tid, std::chrono::nanoseconds runtime, std::chrono::nanoseconds deadline,
+	std::chrono::nanoseconds period)
+{
+	int res = 0;
+
+#if defined(__linux__) && defined(SYS_sched_setattr)
+	struct sched_attr attr = {};
+
+	attr.size = sizeof(attr);
+	attr.sched_policy = SCHED_DEADLINE;
+	attr.sched_runtime = runtime.count();
+	attr.sched_deadline = deadline.count();
+	attr.sched_period = period.count();
+
+	if (syscall(SYS_sched_setattr, tid, &attr, 0) != 0)
+		res = errno;
+#else
+	res = ENOSYS;
+#endif
+
+	if (res != 0)
+	{
+		char msg[30];
+		throw permission_error(strerror_r(res, msg, 30));
+	}
+}
+
 }
 
 priority get_priority(const std::thread & th)
@@ -125,6 +174,12 @@ void set_affinity(std::thread & th, const affinity & a)
 	detail::set_affinity(th.native_handle(), a);
 }
 
+void set_deadline_params(pid_t tid, std::chrono::nanoseconds runtime, std::chrono::nanoseconds deadline,
+	std::chrono::nanoseconds period)
+{
+	detail::set_deadline_params(tid, runtime, deadline, period);
+}
+
 
 namespace this_thread
 {
@@ -149,6 +204,17 @@ void set_affinity(const affinity & a)
 	detail::set_affinity(pthread_self(), a);
 }
 
+pid_t get_tid()
+{
+	return syscall(SYS_gettid);
+}
+
+void set_deadline_params(std::chrono::nanoseconds runtime, std::chrono::nanoseconds deadline,
+	std::chrono::nanoseconds period)
+{
+	detail::set_deadline_params(0, runtime, deadline, period);
+}
+
 }
 
 }
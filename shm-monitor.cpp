@@ -0,0 +1,59 @@
+/**
+ * @file shm-monitor.cpp
+ * 
+ * External monitor: prints the counters that the executive publishes in shared memory (see Executive::set_shm_stats()).
+ * It only reads the segment, so it adds no blocking to the executive.
+ * 
+ * usage: shm-monitor <segment name> [period in ms]
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <cstdlib>
+#include <thread>
+#include <chrono>
+
+#include "shm_stats.h"
+
+int main(int argc, char * argv[])
+{
+	if (argc < 2)
+	{
+		std::cerr << "usage: " << argv[0] << " <segment name> [period in ms]" << std::endl;
+		return 1;
+	}
+
+	std::chrono::milliseconds period(argc > 2 ? std::atoi(argv[2]) : 500);
+
+	shm_stats * stats = nullptr;
+	while ((stats = shm_stats_open(argv[1])) == nullptr)
+	{
+		std::cerr << "waiting for " << argv[1] << "..." << std::endl;
+		std::this_thread::sleep_for(std::chrono::seconds(1));
+	}
+
+	shm_stats::snapshot s;
+	while (true)
+	{
+		stats->read(s);
+
+		std::ostringstream line;
+		line << std::fixed << std::setprecision(3)
+			<< "frame " << s.frame_count << " (id " << s.frame_id << ")"
+			<< "  frame " << s.frame_ns / 1e6 << "ms"
+			<< "  latency " << s.latency_ns / 1e3 << "us"
+			<< "  dispatch " << s.dispatch_ns / 1e3 << "us"
+			<< "  slack " << s.slack_used << "/" << s.slack
+			<< "  aperiodic " << (s.ap_running ? "running" : "idle") << " (misses " << s.ap_misses << ")"
+			<< "  misses";
+		for (auto m: s.misses)
+			line << " " << m;
+
+		std::cout << line.str() << std::endl;
+
+		std::this_thread::sleep_for(period);
+	}
+
+	return 0;
+}
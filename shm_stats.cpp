@@ -0,0 +1,105 @@
+/**
+ * @file shm_stats.cpp
+ */
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <new>
+
+#include "shm_stats.h"
+
+void shm_stats::read(snapshot & s)
+{
+	s.misses.resize(num_tasks);
+
+	while (true)
+	{
+		uint32_t start = seq.load(std::memory_order_acquire);
+		if (start & 1)
+			continue;
+
+		s.frame_count = frame_count.load(std::memory_order_relaxed);
+		s.frame_id = frame_id.load(std::memory_order_relaxed);
+		s.ap_running = ap_running.load(std::memory_order_relaxed);
+		s.ap_misses = ap_misses.load(std::memory_order_relaxed);
+		s.slack = slack.load(std::memory_order_relaxed);
+		s.slack_used = slack_used.load(std::memory_order_relaxed);
+		s.frame_ns = frame_ns.load(std::memory_order_relaxed);
+		s.latency_ns = latency_ns.load(std::memory_order_relaxed);
+		s.dispatch_ns = dispatch_ns.load(std::memory_order_relaxed);
+		for (uint32_t i = 0; i < num_tasks; ++i)
+			s.misses[i] = misses()[i].load(std::memory_order_relaxed);
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (seq.load(std::memory_order_relaxed) == start)
+			return;
+	}
+}
+
+shm_stats * shm_stats_create(const char * name, uint32_t num_tasks, uint32_t frame_length, uint32_t unit_us)
+{
+	int fd = shm_open(name, O_CREAT | O_RDWR | O_TRUNC, 0644);
+	if (fd < 0)
+		return nullptr;
+
+	size_t size = shm_stats::size(num_tasks);
+	if (ftruncate(fd, size) != 0)
+	{
+		close(fd);
+		return nullptr;
+	}
+
+	void * addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (addr == MAP_FAILED)
+		return nullptr;
+
+	mlock(addr, size); //no page faults on the executive's side (best effort)
+
+	shm_stats * stats = new (addr) shm_stats();
+	for (uint32_t i = 0; i < num_tasks; ++i)
+		new (&stats->misses()[i]) std::atomic<uint64_t>(0);
+
+	stats->num_tasks = num_tasks;
+	stats->frame_length = frame_length;
+	stats->unit_us = unit_us;
+	stats->magic = shm_stats::MAGIC;
+
+	return stats;
+}
+
+shm_stats * shm_stats_open(const char * name)
+{
+	int fd = shm_open(name, O_RDONLY, 0);
+	if (fd < 0)
+		return nullptr;
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || (size_t) st.st_size < sizeof(shm_stats))
+	{
+		close(fd);
+		return nullptr;
+	}
+
+	//read-only mapping: the readers only load the sequence counter
+	void * addr = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (addr == MAP_FAILED)
+		return nullptr;
+
+	shm_stats * stats = static_cast<shm_stats *>(addr);
+	if (stats->magic != shm_stats::MAGIC || shm_stats::size(stats->num_tasks) > (size_t) st.st_size)
+	{
+		munmap(addr, st.st_size);
+		return nullptr;
+	}
+
+	return stats;
+}
+
+void shm_stats_close(shm_stats * stats)
+{
+	munmap(stats, shm_stats::size(stats->num_tasks));
+}
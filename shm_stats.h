@@ -0,0 +1,102 @@
+/**
+ * @file shm_stats.h
+ */
+
+#ifndef SHM_STATS_H
+#define SHM_STATS_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+/*
+	Layout of the POSIX shared-memory segment where the executive publishes its counters at every frame.
+	The executive is the only writer and never blocks or enters the kernel: the update is protected by a
+	sequence lock, whose counter is odd while an update is in progress, and readers retry until they
+	copy a consistent snapshot. The per-task miss counters follow the structure.
+*/
+struct shm_stats
+{
+	static const uint32_t MAGIC = 0x45584543;
+
+	uint32_t magic;
+	uint32_t num_tasks;
+	uint32_t frame_length; //units
+	uint32_t unit_us; //unit duration, in microseconds
+
+	std::atomic<uint32_t> seq;
+
+	std::atomic<uint64_t> frame_count; //executed frames
+	std::atomic<uint32_t> frame_id; //last executed frame
+	std::atomic<uint32_t> ap_running; //aperiodic task active
+	std::atomic<uint64_t> ap_misses; //aperiodic deadline misses
+	std::atomic<uint32_t> slack; //slack time of the last frame (units)
+	std::atomic<uint32_t> slack_used; //slack given to the aperiodic task in the last frame (units)
+	std::atomic<int64_t> frame_ns; //duration of the last frame
+	std::atomic<int64_t> latency_ns; //executive's release latency in the last frame
+	std::atomic<int64_t> dispatch_ns; //executive's dispatch time in the last frame
+
+	/* Consistent copy of the counters */
+	struct snapshot
+	{
+		uint64_t frame_count;
+		uint32_t frame_id;
+		uint32_t ap_running;
+		uint64_t ap_misses;
+		uint32_t slack;
+		uint32_t slack_used;
+		int64_t frame_ns;
+		int64_t latency_ns;
+		int64_t dispatch_ns;
+		std::vector<uint64_t> misses;
+	};
+
+	static size_t size(uint32_t num_tasks);
+
+	std::atomic<uint64_t> * misses();
+
+	// writer side (executive)
+	void begin_write();
+	void end_write();
+
+	// reader side: retries while the writer is updating
+	void read(snapshot & s);
+};
+
+/*
+	Creates (or truncates) the segment "name" and maps it, locked in memory. Returns nullptr on failure.
+*/
+shm_stats * shm_stats_create(const char * name, uint32_t num_tasks, uint32_t frame_length, uint32_t unit_us);
+
+/*
+	Maps an existing segment for reading. Returns nullptr on failure.
+*/
+shm_stats * shm_stats_open(const char * name);
+
+void shm_stats_close(shm_stats * stats);
+
+// ...............................................................................................
+
+inline size_t shm_stats::size(uint32_t num_tasks)
+{
+	return sizeof(shm_stats) + num_tasks * sizeof(std::atomic<uint64_t>);
+}
+
+inline std::atomic<uint64_t> * shm_stats::misses()
+{
+	return reinterpret_cast<std::atomic<uint64_t> *>(this + 1);
+}
+
+inline void shm_stats::begin_write()
+{
+	seq.store(seq.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+}
+
+inline void shm_stats::end_write()
+{
+	seq.store(seq.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+#endif
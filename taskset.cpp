@@ -0,0 +1,78 @@
+/**
+ * @file taskset.cpp
+ */
+
+#include <cmath>
+#include <algorithm>
+#include <memory>
+
+#include "taskset.h"
+
+std::vector<double> uunifast(size_t n, double utilization, std::mt19937 & rng)
+{
+	std::uniform_real_distribution<double> uniform(0.0, 1.0);
+	std::vector<double> u(n);
+	
+	double sum = utilization;
+	for (size_t i = 0; i + 1 < n; ++i)
+	{
+		double next = sum * std::pow(uniform(rng), 1.0 / (n - i - 1));
+		u[i] = sum - next;
+		sum = next;
+	}
+	u[n - 1] = sum;
+
+	return u;
+}
+
+std::vector<task_spec> generate_taskset(size_t n, double utilization, period_set periods, unsigned int frame_length, std::mt19937 & rng)
+{
+	std::uniform_int_distribution<unsigned int> harmonic(0, 4);
+	std::uniform_int_distribution<unsigned int> non_harmonic(2, 6);
+
+	std::vector<double> u = uunifast(n, utilization, rng);
+	std::vector<task_spec> tasks(n);
+
+	for (size_t i = 0; i < n; ++i)
+	{
+		if (periods == HARMONIC)
+			tasks[i].period = frame_length << harmonic(rng);
+		else
+			tasks[i].period = frame_length * non_harmonic(rng);
+
+		tasks[i].wcet = std::max(1u, (unsigned int) std::lround(u[i] * tasks[i].period));
+	}
+
+	return tasks;
+}
+
+bool configure_executive(Executive & exec, const std::vector<task_spec> & tasks, unsigned int frame_length,
+	std::function<void(size_t, unsigned int)> body)
+{
+	for (size_t id = 0; id < tasks.size(); ++id)
+	{
+		if (tasks[id].wcet > frame_length)
+		{
+			//the job is complete when its slices have consumed the whole wcet
+			unsigned int wcet = tasks[id].wcet;
+			std::shared_ptr<unsigned int> done = std::make_shared<unsigned int>(0);
+			
+			exec.set_resumable_task(id, [body, id, wcet, done](unsigned int budget)
+				{
+					body(id, budget);
+					*done += budget;
+					if (*done < wcet)
+						return false;
+					*done = 0;
+					return true;
+				}, wcet, tasks[id].period);
+		}
+		else
+		{
+			unsigned int wcet = tasks[id].wcet;
+			exec.set_periodic_task(id, [body, id, wcet]() { body(id, wcet); }, wcet, tasks[id].period);
+		}
+	}
+
+	return exec.build_schedule();
+}
@@ -0,0 +1,47 @@
+/**
+ * @file taskset.h
+ */
+
+#ifndef TASKSET_H
+#define TASKSET_H
+
+#include <vector>
+#include <random>
+#include <functional>
+
+#include "executive.h"
+
+/* Parameters of a periodic task, in units (deadline = period) */
+struct task_spec
+{
+	unsigned int period;
+	unsigned int wcet;
+};
+
+enum period_set {HARMONIC, NON_HARMONIC};
+
+/* 
+	UUniFast: splits the total utilization uniformly among n tasks.
+*/
+std::vector<double> uunifast(size_t n, double utilization, std::mt19937 & rng);
+
+/* 
+	Random periodic task set:
+	n: number of tasks;
+	utilization: total utilization (before the wcets are rounded to units);
+	periods: HARMONIC periods are frame_length * 2^k (k in [0, 4]), NON_HARMONIC periods are frame_length * [2, 6],
+	so that the frame length always divides the hyperperiod;
+	frame_length: frame length, in units.
+*/
+std::vector<task_spec> generate_taskset(size_t n, double utilization, period_set periods, unsigned int frame_length, std::mt19937 & rng);
+
+/* 
+	Configures the executive with the task set and builds its schedule:
+	tasks whose wcet exceeds the frame length are set as resumable tasks, the others as periodic tasks;
+	body(task_id, budget) is executed by each job (or slice) with its budget, in units.
+	Returns false if build_schedule() finds no feasible schedule.
+*/
+bool configure_executive(Executive & exec, const std::vector<task_spec> & tasks, unsigned int frame_length,
+	std::function<void(size_t, unsigned int)> body);
+
+#endif
@@ -0,0 +1,82 @@
+/**
+ * @file tick-source.cpp
+ * 
+ * External cycle simulator for external_tick_clock (see frame_clock.h): produces one tick every period,
+ * either writing a byte to a FIFO or incrementing a counter in a POSIX shared-memory segment.
+ * 
+ * usage: tick-source fifo <path> <period in us>
+ *        tick-source shm <name> <period in us>
+ */
+
+#include <iostream>
+#include <cstring>
+#include <cstdlib>
+#include <ctime>
+#include <atomic>
+#include <cstdint>
+#include <new>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+int main(int argc, char * argv[])
+{
+	if (argc < 4 || (std::strcmp(argv[1], "fifo") != 0 && std::strcmp(argv[1], "shm") != 0))
+	{
+		std::cerr << "usage: " << argv[0] << " fifo|shm <path or name> <period in us>" << std::endl;
+		return 1;
+	}
+
+	bool fifo = std::strcmp(argv[1], "fifo") == 0;
+	long period = std::atol(argv[3]) * 1000;
+
+	int fd = -1;
+	std::atomic<uint64_t> * counter = nullptr;
+
+	if (fifo)
+	{
+		mkfifo(argv[2], 0644);
+		fd = open(argv[2], O_WRONLY); //blocks until the executive opens the FIFO
+	}
+	else
+	{
+		fd = shm_open(argv[2], O_CREAT | O_RDWR, 0644);
+		if (fd >= 0 && ftruncate(fd, sizeof(std::atomic<uint64_t>)) == 0)
+		{
+			void * addr = mmap(nullptr, sizeof(std::atomic<uint64_t>), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+			if (addr != MAP_FAILED)
+				counter = new (addr) std::atomic<uint64_t>(0);
+		}
+	}
+
+	if (fd < 0 || (!fifo && counter == nullptr))
+	{
+		std::cerr << "Error opening " << argv[2] << ": " << std::strerror(errno) << std::endl;
+		return 1;
+	}
+
+	struct timespec next;
+	clock_gettime(CLOCK_MONOTONIC, &next);
+
+	while (true)
+	{
+		next.tv_nsec += period;
+		next.tv_sec += next.tv_nsec / 1000000000L;
+		next.tv_nsec %= 1000000000L;
+		clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, nullptr);
+
+		if (fifo)
+		{
+			char tick = 1;
+			if (write(fd, &tick, 1) < 0)
+				break; //reader closed
+		}
+		else
+		{
+			counter->fetch_add(1, std::memory_order_release);
+		}
+	}
+
+	return 0;
+}